@@ -0,0 +1,90 @@
+/* Abstraction-penalty benchmarks for range.hpp: every range() variant is
+ * paired with the raw loop it is supposed to compile down to. Run these
+ * before and after touching the headers.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <numeric>
+#include <vector>
+
+#include "range.hpp"
+
+namespace {
+
+    constexpr std::size_t N = 1 << 20;
+
+    void raw_for_sum(benchmark::State& state) {
+        for (auto _ : state) {
+            std::size_t sum = 0;
+            for (std::size_t i = 0; i < N; ++i)
+                sum += i;
+            benchmark::DoNotOptimize(sum);
+        }
+    }
+    BENCHMARK(raw_for_sum);
+
+    void range_sum(benchmark::State& state) {
+        for (auto _ : state) {
+            std::size_t sum = 0;
+            for (auto i : util::range(N))
+                sum += i;
+            benchmark::DoNotOptimize(sum);
+        }
+    }
+    BENCHMARK(range_sum);
+
+    void raw_for_indexed_store(benchmark::State& state) {
+        std::vector<float> out(N);
+        for (auto _ : state) {
+            for (std::size_t i = 0; i < N; ++i)
+                out[i] = static_cast<float>(i) * 0.5f;
+            benchmark::DoNotOptimize(out.data());
+            benchmark::ClobberMemory();
+        }
+    }
+    BENCHMARK(raw_for_indexed_store);
+
+    void range_indexed_store(benchmark::State& state) {
+        std::vector<float> out(N);
+        for (auto _ : state) {
+            for (auto i : util::range(N))
+                out[i] = static_cast<float>(i) * 0.5f;
+            benchmark::DoNotOptimize(out.data());
+            benchmark::ClobberMemory();
+        }
+    }
+    BENCHMARK(range_indexed_store);
+
+    void range_strided_sum(benchmark::State& state) {
+        for (auto _ : state) {
+            std::size_t sum = 0;
+            for (auto i : util::range<std::size_t>(0, N, 4))
+                sum += i;
+            benchmark::DoNotOptimize(sum);
+        }
+    }
+    BENCHMARK(range_strided_sum);
+
+    void raw_strided_sum(benchmark::State& state) {
+        for (auto _ : state) {
+            std::size_t sum = 0;
+            for (std::size_t i = 0; i < N; i += 4)
+                sum += i;
+            benchmark::DoNotOptimize(sum);
+        }
+    }
+    BENCHMARK(raw_strided_sum);
+
+    /// std::accumulate through the random access iterator interface
+    void range_accumulate(benchmark::State& state) {
+        auto r = util::range(N);
+        for (auto _ : state) {
+            std::size_t sum = std::accumulate(r.begin(), r.end(), std::size_t(0));
+            benchmark::DoNotOptimize(sum);
+        }
+    }
+    BENCHMARK(range_accumulate);
+
+}
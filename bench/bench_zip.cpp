@@ -0,0 +1,138 @@
+/* Abstraction-penalty benchmarks for zip.hpp: zips of 2/3/4 vectors against
+ * the manual indexed loops they replace, plus the advance and dereference
+ * costs called out by profiling.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <vector>
+
+#include "zip.hpp"
+
+namespace {
+
+    constexpr std::size_t N = 1 << 20;
+
+    std::vector<double> filled(double seed) {
+        std::vector<double> v(N);
+        for (std::size_t i = 0; i < N; ++i)
+            v[i] = seed + static_cast<double>(i);
+        return v;
+    }
+
+    void manual_indexed_2(benchmark::State& state) {
+        auto a = filled(1), b = filled(2);
+        for (auto _ : state) {
+            double sum = 0;
+            for (std::size_t i = 0; i < N; ++i)
+                sum += a[i] * b[i];
+            benchmark::DoNotOptimize(sum);
+        }
+    }
+    BENCHMARK(manual_indexed_2);
+
+    void zip_2(benchmark::State& state) {
+        auto a = filled(1), b = filled(2);
+        for (auto _ : state) {
+            double sum = 0;
+            for (auto t : util::zip(a, b))
+                sum += std::get<0>(t) * std::get<1>(t);
+            benchmark::DoNotOptimize(sum);
+        }
+    }
+    BENCHMARK(zip_2);
+
+    void zip_fast_2(benchmark::State& state) {
+        auto a = filled(1), b = filled(2);
+        for (auto _ : state) {
+            double sum = 0;
+            for (auto t : util::zip_fast(a, b))
+                sum += std::get<0>(t) * std::get<1>(t);
+            benchmark::DoNotOptimize(sum);
+        }
+    }
+    BENCHMARK(zip_fast_2);
+
+    void manual_indexed_3(benchmark::State& state) {
+        auto a = filled(1), b = filled(2), c = filled(3);
+        for (auto _ : state) {
+            double sum = 0;
+            for (std::size_t i = 0; i < N; ++i)
+                sum += a[i] * b[i] + c[i];
+            benchmark::DoNotOptimize(sum);
+        }
+    }
+    BENCHMARK(manual_indexed_3);
+
+    void zip_3(benchmark::State& state) {
+        auto a = filled(1), b = filled(2), c = filled(3);
+        for (auto _ : state) {
+            double sum = 0;
+            for (auto t : util::zip(a, b, c))
+                sum += std::get<0>(t) * std::get<1>(t) + std::get<2>(t);
+            benchmark::DoNotOptimize(sum);
+        }
+    }
+    BENCHMARK(zip_3);
+
+    void for_each_zipped_3(benchmark::State& state) {
+        auto a = filled(1), b = filled(2), c = filled(3);
+        for (auto _ : state) {
+            double sum = 0;
+            util::for_each_zipped(
+                [&](double x, double y, double z) { sum += x * y + z; },
+                a, b, c);
+            benchmark::DoNotOptimize(sum);
+        }
+    }
+    BENCHMARK(for_each_zipped_3);
+
+    void manual_indexed_4(benchmark::State& state) {
+        auto a = filled(1), b = filled(2), c = filled(3), d = filled(4);
+        for (auto _ : state) {
+            double sum = 0;
+            for (std::size_t i = 0; i < N; ++i)
+                sum += a[i] * b[i] + c[i] * d[i];
+            benchmark::DoNotOptimize(sum);
+        }
+    }
+    BENCHMARK(manual_indexed_4);
+
+    void zip_4(benchmark::State& state) {
+        auto a = filled(1), b = filled(2), c = filled(3), d = filled(4);
+        for (auto _ : state) {
+            double sum = 0;
+            for (auto t : util::zip(a, b, c, d))
+                sum += std::get<0>(t) * std::get<1>(t)
+                    + std::get<2>(t) * std::get<3>(t);
+            benchmark::DoNotOptimize(sum);
+        }
+    }
+    BENCHMARK(zip_4);
+
+    /// Cost of zip_iterator::operator+= for large offsets (thread sharding)
+    void zip_advance(benchmark::State& state) {
+        auto a = filled(1), b = filled(2);
+        auto z = util::zip(a, b);
+        for (auto _ : state) {
+            auto it = z.begin();
+            it += N - 1;
+            benchmark::DoNotOptimize(it);
+        }
+    }
+    BENCHMARK(zip_advance);
+
+    /// Cost of building the reference_tuple on every dereference
+    void zip_dereference(benchmark::State& state) {
+        auto a = filled(1), b = filled(2);
+        auto z = util::zip(a, b);
+        auto it = z.begin();
+        for (auto _ : state) {
+            auto t = *it;
+            benchmark::DoNotOptimize(t);
+        }
+    }
+    BENCHMARK(zip_dereference);
+
+}
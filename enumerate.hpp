@@ -0,0 +1,101 @@
+#ifndef _UTIL_ENUMERATE_HPP_
+#define _UTIL_ENUMERATE_HPP_
+
+/* Indexed iteration over one container, the common case of
+ * zip(range(v.size()), v) without zip's per-step tuple increment and
+ * double end comparison.
+ *
+ * usage:
+ *     for(auto e : enumerate(names)) {
+ *         std::cout << e.first << ": " << e.second << std::endl;
+ *     }
+ *     for(auto e : enumerate(names, 1))  // 1-based index
+ *         ...
+ */
+
+#include <cstddef>
+#include <utility>
+
+#include "range.hpp"
+#include "zip.hpp"
+
+namespace util {
+
+    /** Counting iterator over one container
+     *
+     * Pairs a free-running Range::Iterator counter with the container's own
+     * iterator. Only the container iterator takes part in the end
+     * comparison, so each step costs one increment pair and one compare.
+     */
+    template<class Container, typename IndexType = std::size_t>
+    class enumerate_iterator {
+    public:
+        using inner_iterator = typename iterator_extractor<Container>::type;
+        using inner_reference = typename reference_extractor<Container>::type;
+        /// Index by value, element by reference
+        using reference = std::pair<IndexType, inner_reference>;
+
+        enumerate_iterator(IndexType index, inner_iterator it)
+            : _index(index), _it(it) {}
+
+        enumerate_iterator& operator++() {
+            ++_index;
+            ++_it;
+            return *this;
+        }
+
+        reference operator*() const {
+            return reference(*_index, *_it);
+        }
+
+        /// Only the container iterator decides when the loop ends
+        bool operator==(const enumerate_iterator& other) const {
+            return _it == other._it;
+        }
+
+        bool operator!=(const enumerate_iterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        typename Range<IndexType>::Iterator _index;
+        inner_iterator _it;
+    };
+
+
+    /** Dummy container for enumerated ranged loops
+     *
+     * \tparam Container The wrapped container type, a reference for lvalue
+     *         arguments.
+     */
+    template<class Container, typename IndexType = std::size_t>
+    struct enumerate_impl {
+        /// The enumerating iterator type
+        using iterator = enumerate_iterator<Container, IndexType>;
+
+        Container _container;
+        IndexType _start;
+
+        enumerate_impl(Container&& container, IndexType start)
+            : _container(std::forward<Container>(container)), _start(start) {}
+
+        iterator begin() {
+            return iterator(_start, _container.begin());
+        }
+
+        iterator end() {
+            // the index of the end iterator never gets compared
+            return iterator(_start, _container.end());
+        }
+    };
+
+    /* The enumerate wrapper function, with an optional starting index. */
+    template<class Container, typename IndexType = std::size_t>
+    auto enumerate(Container&& container, IndexType start = 0)
+        -> enumerate_impl<Container, IndexType> {
+        return enumerate_impl<Container, IndexType>(
+            std::forward<Container>(container), start);
+    }
+
+}
+#endif
@@ -0,0 +1,200 @@
+#ifndef _UTIL_GATHER_HPP_
+#define _UTIL_GATHER_HPP_
+
+/* Batched gather/scatter kernels for permutation-style passes.
+ *
+ * The naive loop - for(auto i : range(n)) dst[perm[i]] = src[i]; - is
+ * latency bound: every element waits on an unpredictable address. These
+ * kernels process indices in blocks, issuing prefetches for the whole
+ * block while the indices are read and only then moving the data, so
+ * several cache misses are in flight at once.
+ *
+ * usage:
+ *     auto picked = gather(src, indices);          // new vector
+ *     gather(src, range(0, n, 2), dst);            // into dst[0..]
+ *     scatter(dst, perm, src);                     // dst[perm[k]] = src[k]
+ *
+ * The index source may be a Range, a container or any zip-compatible
+ * iterable; values are indexed with operator[]. Sources with a size()
+ * bound the loop by it, so a strided Range whose end value is off the
+ * stride grid (range(0, n, 2) with odd n) terminates correctly; an
+ * unsized source must make its end iterator reachable by ++. For
+ * vector<float> and vector<int32_t> with int32 indices, hardware gather
+ * instructions are used where the build enables them (AVX2).
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "zip.hpp"
+
+namespace util {
+
+    /// Portable wrapper around the compiler's prefetch-for-write hint
+    template<class T>
+    inline void prefetch_write(T* address) {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(address, 1, 3);
+#else
+        (void)address;
+#endif
+    }
+
+    namespace gather_impl {
+
+        /* Indices per pipeline stage: enough outstanding prefetches to
+         * cover main-memory latency, small enough to stay in L1. */
+        constexpr std::size_t block_size = 32;
+
+        /* Trip count of an index source: size() when it has one -
+         * authoritative even when the end value is off the stride grid,
+         * like Range's own engine loops - otherwise unbounded and the
+         * iterator comparison alone decides. */
+        template<class C>
+        auto trip_count(const C& c, int) -> decltype(c.size(), std::size_t()) {
+            return c.size();
+        }
+
+        template<class C>
+        std::size_t trip_count(const C&, long) {
+            return static_cast<std::size_t>(-1);
+        }
+    }
+
+    /* Gather src[i] for every index i into dst, in index order.
+     *
+     * dst must be indexable up to the number of indices. Indices are read
+     * a block at a time; every target element is prefetched while its
+     * block is still being decoded, then the block is moved.
+     */
+    template<class Src, class Indices, class Dst>
+    void gather(const Src& src, Indices&& indices, Dst& dst) {
+        std::size_t block[gather_impl::block_size];
+        auto it = indices.begin();
+        const auto last = indices.end();
+        std::size_t remaining = gather_impl::trip_count(indices, 0);
+        std::size_t out = 0;
+        while (remaining > 0 && it != last) {
+            std::size_t filled = 0;
+            for (; filled < gather_impl::block_size
+                 && remaining > 0 && it != last;
+                 ++filled, ++it, --remaining) {
+                block[filled] = static_cast<std::size_t>(*it);
+                prefetch_read(&src[block[filled]]);
+            }
+            for (std::size_t j = 0; j < filled; ++j)
+                dst[out++] = src[block[j]];
+        }
+    }
+
+    /// Gather into a freshly built vector
+    template<class Src, class Indices>
+    std::vector<typename std::remove_reference<Src>::type::value_type>
+    gather(const Src& src, Indices&& indices) {
+        std::vector<typename std::remove_reference<Src>::type::value_type> dst;
+        std::size_t block[gather_impl::block_size];
+        auto it = indices.begin();
+        const auto last = indices.end();
+        std::size_t remaining = gather_impl::trip_count(indices, 0);
+        if (remaining != static_cast<std::size_t>(-1))
+            dst.reserve(remaining);
+        while (remaining > 0 && it != last) {
+            std::size_t filled = 0;
+            for (; filled < gather_impl::block_size
+                 && remaining > 0 && it != last;
+                 ++filled, ++it, --remaining) {
+                block[filled] = static_cast<std::size_t>(*it);
+                prefetch_read(&src[block[filled]]);
+            }
+            for (std::size_t j = 0; j < filled; ++j)
+                dst.push_back(src[block[j]]);
+        }
+        return dst;
+    }
+
+    /* Scatter values[k] to dst[indices[k]] for every k.
+     *
+     * The write targets are prefetched for ownership a block ahead, so
+     * the read-for-ownership misses overlap. indices and values advance
+     * in lockstep; values must not be shorter than indices.
+     */
+    template<class Dst, class Indices, class Values>
+    void scatter(Dst& dst, Indices&& indices, const Values& values) {
+        std::size_t block[gather_impl::block_size];
+        auto it = indices.begin();
+        const auto last = indices.end();
+        auto val = values.begin();
+        std::size_t remaining = gather_impl::trip_count(indices, 0);
+        while (remaining > 0 && it != last) {
+            std::size_t filled = 0;
+            for (; filled < gather_impl::block_size
+                 && remaining > 0 && it != last;
+                 ++filled, ++it, --remaining) {
+                block[filled] = static_cast<std::size_t>(*it);
+                prefetch_write(&dst[block[filled]]);
+            }
+            for (std::size_t j = 0; j < filled; ++j, ++val)
+                dst[block[j]] = *val;
+        }
+    }
+
+#ifdef __AVX2__
+
+    namespace gather_impl {
+
+        inline void gather_f32(const float* src, const std::int32_t* idx,
+                               float* dst, std::size_t count) {
+            std::size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                const __m256i lanes = _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(idx + i));
+                _mm256_storeu_ps(dst + i,
+                                 _mm256_i32gather_ps(src, lanes, 4));
+            }
+            for (; i < count; ++i)
+                dst[i] = src[idx[i]];
+        }
+
+        inline void gather_i32(const std::int32_t* src, const std::int32_t* idx,
+                               std::int32_t* dst, std::size_t count) {
+            std::size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                const __m256i lanes = _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(idx + i));
+                const __m256i picked = _mm256_i32gather_epi32(src, lanes, 4);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), picked);
+            }
+            for (; i < count; ++i)
+                dst[i] = src[idx[i]];
+        }
+    }
+
+    /* Hardware paths for the common concrete case: contiguous 32-bit
+     * data with contiguous 32-bit indices, eight elements per gather
+     * instruction. (There is no scatter instruction below AVX-512, so
+     * scatter keeps the prefetch pipeline on every build.) */
+    inline void gather(const std::vector<float>& src,
+                       const std::vector<std::int32_t>& indices,
+                       std::vector<float>& dst) {
+        gather_impl::gather_f32(src.data(), indices.data(), dst.data(),
+                                indices.size());
+    }
+
+    inline void gather(const std::vector<std::int32_t>& src,
+                       const std::vector<std::int32_t>& indices,
+                       std::vector<std::int32_t>& dst) {
+        gather_impl::gather_i32(src.data(), indices.data(), dst.data(),
+                                indices.size());
+    }
+
+#endif  // __AVX2__
+
+}
+#endif
@@ -0,0 +1,151 @@
+#ifndef _UTIL_GENERATOR_HPP_
+#define _UTIL_GENERATOR_HPP_
+
+/* A coroutine-backed iterable for streaming ingestion: the producer is
+ * written as a plain function with co_yield, the consumer sees an
+ * ordinary container that plugs into the rest of the library.
+ *
+ * usage:
+ *     util::generator<Record> parse(std::istream& in) {
+ *         Record r;
+ *         while(read_record(in, r))
+ *             co_yield r;
+ *     }
+ *
+ *     for(auto&& [rec, i] : zip(parse(file), range(max)))
+ *         ...
+ *
+ * Single pass: begin() may be called once, and advancing the iterator
+ * resumes the coroutine. Requires C++20; the rest of the library stays
+ * C++11-clean by keeping this in its own header.
+ */
+
+#if !defined(__cpp_impl_coroutine)
+#error "generator.hpp requires C++20 coroutine support (-std=c++20)"
+#endif
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <utility>
+
+namespace util {
+
+    /** A lazy sequence of T produced by a coroutine
+     *
+     * Move-only owner of the coroutine frame. Values are yielded by
+     * reference into the frame, so dereferencing copies nothing.
+     */
+    template<class T>
+    class generator {
+    public:
+
+        struct promise_type {
+            const T* _value = nullptr;
+            std::exception_ptr _exception;
+
+            generator get_return_object() {
+                return generator(
+                    std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+            std::suspend_always initial_suspend() noexcept {
+                return {};
+            }
+            std::suspend_always final_suspend() noexcept {
+                return {};
+            }
+            std::suspend_always yield_value(const T& value) noexcept {
+                _value = &value;
+                return {};
+            }
+            void return_void() noexcept {}
+            void unhandled_exception() {
+                _exception = std::current_exception();
+            }
+        };
+
+        class iterator {
+            std::coroutine_handle<promise_type> _handle;
+
+            bool exhausted() const {
+                return ! _handle || _handle.done();
+            }
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const T*;
+            using reference = const T&;
+
+            iterator() noexcept : _handle(nullptr) {}
+            explicit iterator(std::coroutine_handle<promise_type> handle) noexcept
+                : _handle(handle) {}
+
+            reference operator*() const {
+                return *_handle.promise()._value;
+            }
+            pointer operator->() const {
+                return _handle.promise()._value;
+            }
+            iterator& operator++() {
+                _handle.resume();
+                if(_handle.promise()._exception)
+                    std::rethrow_exception(_handle.promise()._exception);
+                return *this;
+            }
+            /* Both iterators at the end compare equal; a live iterator
+             * never equals the end sentinel. */
+            bool operator==(const iterator& other) const {
+                return exhausted() == other.exhausted();
+            }
+            bool operator!=(const iterator& other) const {
+                return ! (*this == other);
+            }
+        };
+
+        using const_iterator = iterator;
+        using value_type = T;
+        using reference = const T&;
+        using const_reference = const T&;
+
+        generator() noexcept : _handle(nullptr) {}
+        generator(generator&& other) noexcept
+            : _handle(std::exchange(other._handle, nullptr)) {}
+        generator& operator=(generator&& other) noexcept {
+            if(this != &other) {
+                if(_handle)
+                    _handle.destroy();
+                _handle = std::exchange(other._handle, nullptr);
+            }
+            return *this;
+        }
+        generator(const generator&) = delete;
+        generator& operator=(const generator&) = delete;
+        ~generator() {
+            if(_handle)
+                _handle.destroy();
+        }
+
+        /// Runs the coroutine up to the first co_yield
+        iterator begin() {
+            if(_handle) {
+                _handle.resume();
+                if(_handle.promise()._exception)
+                    std::rethrow_exception(_handle.promise()._exception);
+            }
+            return iterator(_handle);
+        }
+        iterator end() {
+            return iterator();
+        }
+
+    private:
+        explicit generator(std::coroutine_handle<promise_type> handle) noexcept
+            : _handle(handle) {}
+
+        std::coroutine_handle<promise_type> _handle;
+    };
+
+}
+#endif
@@ -0,0 +1,38 @@
+#ifndef _UTIL_INSTANTIATIONS_HPP_
+#define _UTIL_INSTANTIATIONS_HPP_
+
+/* Opt-in build-time relief for heavy users of the headers.
+ *
+ * Including this header after range.hpp/zip.hpp tells the compiler NOT
+ * to instantiate the most common specializations in the current
+ * translation unit; the definitions come from the small cpp-utils-compiled
+ * library instead. Runtime behavior is identical - the definitions stay
+ * visible for inlining - but hundreds of translation units stop paying
+ * the instantiation cost each.
+ *
+ * usage:
+ *     #include "range.hpp"
+ *     #include "zip.hpp"
+ *     #include "instantiations.hpp"
+ *     // ... and link against cpp-utils-compiled
+ */
+
+#include <cstddef>
+#include <vector>
+
+#include "range.hpp"
+#include "zip.hpp"
+
+namespace util {
+
+    extern template class Range<std::size_t>;
+    extern template class Range<int>;
+
+    // the binary zip over vectors, the dominant case
+    extern template class zip_iterator<std::vector<double>&, std::vector<double>&>;
+    extern template struct zip_impl<std::vector<double>&, std::vector<double>&>;
+    extern template class zip_iterator<std::vector<float>&, std::vector<float>&>;
+    extern template struct zip_impl<std::vector<float>&, std::vector<float>&>;
+
+}
+#endif
@@ -0,0 +1,184 @@
+#ifndef _UTIL_LINSPACE_HPP_
+#define _UTIL_LINSPACE_HPP_
+
+/* count evenly spaced floating-point samples over [a, b], endpoints
+ * included, as a Range-family container.
+ *
+ * usage:
+ *     for(double x : linspace(0.0, 1.0, 1001))
+ *         acc += f(x);
+ *     parallel_for(range(lin.size()), ...) with lin[i] for the sample
+ *
+ * Every point is computed as fma(i, step, a) from the integer index, not
+ * by accumulating the step: no drift over millions of samples, no
+ * loop-carried floating-point add on the critical path (the multiply
+ * pipelines independently per lane), and the first and last points are
+ * exactly a and b.
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace util {
+
+    /** The linspace container: count samples from a to b inclusive
+     *
+     * Random access and trivially copyable, like Range. Dereference
+     * returns the sample by value.
+     */
+    template<typename FloatType = double>
+    class Linspace_Range {
+        static_assert(std::is_floating_point<FloatType>::value,
+                      "linspace needs a floating-point sample type");
+
+        FloatType _a;
+        FloatType _b;
+        FloatType _step;
+        std::size_t _count;
+
+        FloatType value_at(std::size_t i) const noexcept {
+            // the endpoints are returned verbatim, everything between is
+            // one fma from the index
+            if (i == 0)
+                return _a;
+            if (i + 1 >= _count)
+                return _b;
+            return std::fma(static_cast<FloatType>(i), _step, _a);
+        }
+
+    public:
+
+        /* Self-contained like Range::Iterator: carries the parameters by
+         * value, so it never dangles and stays trivially copyable. */
+        class Iterator {
+            Linspace_Range _range;
+            std::size_t _i;
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = FloatType;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const FloatType*;
+            using reference = FloatType;
+
+            Iterator() noexcept : _range(FloatType(0), FloatType(0), 0), _i(0) {}
+            Iterator(const Linspace_Range& range, std::size_t i) noexcept
+                : _range(range), _i(i) {}
+
+            FloatType operator*() const noexcept {
+                return _range.value_at(_i);
+            }
+            FloatType operator[](difference_type n) const noexcept {
+                return _range.value_at(_i + n);
+            }
+
+            Iterator& operator++() noexcept {
+                ++_i;
+                return *this;
+            }
+            Iterator operator++(int) noexcept {
+                Iterator old = *this;
+                ++_i;
+                return old;
+            }
+            Iterator& operator--() noexcept {
+                --_i;
+                return *this;
+            }
+            Iterator operator--(int) noexcept {
+                Iterator old = *this;
+                --_i;
+                return old;
+            }
+            Iterator& operator+=(difference_type n) noexcept {
+                _i += n;
+                return *this;
+            }
+            Iterator& operator-=(difference_type n) noexcept {
+                _i -= n;
+                return *this;
+            }
+            friend Iterator operator+(Iterator it, difference_type n) noexcept {
+                it += n;
+                return it;
+            }
+            friend Iterator operator+(difference_type n, Iterator it) noexcept {
+                it += n;
+                return it;
+            }
+            friend Iterator operator-(Iterator it, difference_type n) noexcept {
+                it -= n;
+                return it;
+            }
+            friend difference_type operator-(const Iterator& lhs,
+                                             const Iterator& rhs) noexcept {
+                return static_cast<difference_type>(lhs._i)
+                    - static_cast<difference_type>(rhs._i);
+            }
+
+            friend bool operator==(const Iterator& lhs, const Iterator& rhs) noexcept {
+                return lhs._i == rhs._i;
+            }
+            friend bool operator!=(const Iterator& lhs, const Iterator& rhs) noexcept {
+                return lhs._i != rhs._i;
+            }
+            friend bool operator<(const Iterator& lhs, const Iterator& rhs) noexcept {
+                return lhs._i < rhs._i;
+            }
+            friend bool operator>(const Iterator& lhs, const Iterator& rhs) noexcept {
+                return rhs < lhs;
+            }
+            friend bool operator<=(const Iterator& lhs, const Iterator& rhs) noexcept {
+                return ! (rhs < lhs);
+            }
+            friend bool operator>=(const Iterator& lhs, const Iterator& rhs) noexcept {
+                return ! (lhs < rhs);
+            }
+        };
+
+        using iterator = Iterator;
+        using const_iterator = Iterator;
+        using value_type = FloatType;
+        using reference = FloatType;
+        using const_reference = FloatType;
+
+        Linspace_Range(FloatType a, FloatType b, std::size_t count) noexcept
+            : _a(a), _b(b),
+              _step(count > 1
+                    ? (b - a) / static_cast<FloatType>(count - 1)
+                    : FloatType(0)),
+              _count(count) {}
+
+        Iterator begin() const noexcept {
+            return Iterator(*this, 0);
+        }
+        Iterator end() const noexcept {
+            return Iterator(*this, _count);
+        }
+
+        std::size_t size() const noexcept {
+            return _count;
+        }
+        bool empty() const noexcept {
+            return _count == 0;
+        }
+        FloatType operator[](std::size_t i) const noexcept {
+            return value_at(i);
+        }
+        /// The spacing between consecutive samples
+        FloatType step() const noexcept {
+            return _step;
+        }
+    };
+
+    /* The linspace wrapper function. count == 1 yields just a, count == 0
+     * an empty range. */
+    template<typename FloatType>
+    Linspace_Range<FloatType> linspace(FloatType a, FloatType b,
+                                       std::size_t count) noexcept {
+        return Linspace_Range<FloatType>(a, b, count);
+    }
+
+}
+#endif
@@ -0,0 +1,144 @@
+#ifndef _UTIL_MMAP_RANGE_HPP_
+#define _UTIL_MMAP_RANGE_HPP_
+
+/* A zero-copy container view over a memory-mapped file (POSIX).
+ *
+ * The file content is exposed as a contiguous array of T straight from the
+ * page cache - no read loop, no staging vector - with the iterator and
+ * reference typedefs the zip machinery expects, so columns can be zipped
+ * without loading them:
+ *
+ *     auto a = mmap_range<float>("a.col", mmap_advice::sequential);
+ *     auto b = mmap_range<float>("b.col", mmap_advice::sequential);
+ *     for(auto&& [x, y] : zip(a, b))
+ *         ...
+ *
+ * The mapping is read-only; errors surface as std::system_error.
+ */
+
+#include <cerrno>
+#include <cstddef>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace util {
+
+    /// Access-pattern hint forwarded to madvise at mapping time
+    enum class mmap_advice {
+        normal,      ///< no hint
+        sequential,  ///< front-to-back streaming, aggressive readahead
+        willneed     ///< fault the pages in eagerly
+    };
+
+    /** Read-only mapped view of a file as an array of T
+     *
+     * Owns the mapping (movable, not copyable) and unmaps on destruction.
+     * A trailing partial element, if the file size is not a multiple of
+     * sizeof(T), is not exposed.
+     */
+    template<typename T>
+    class Mmap_Range {
+        const T* _data = nullptr;
+        std::size_t _count = 0;
+        std::size_t _bytes = 0;
+    public:
+        /// Element type stored in the file
+        using value_type = T;
+        /// The mapping is read-only, so both iterators are const
+        using iterator = const T*;
+        using const_iterator = const T*;
+        using reference = const T&;
+        using const_reference = const T&;
+
+        explicit Mmap_Range(const std::string& path,
+                            mmap_advice advice = mmap_advice::normal) {
+            const int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+                throw std::system_error(errno, std::generic_category(),
+                                        "open " + path);
+            struct stat file_info;
+            if (::fstat(fd, &file_info) != 0) {
+                const int open_errno = errno;
+                ::close(fd);
+                throw std::system_error(open_errno, std::generic_category(),
+                                        "fstat " + path);
+            }
+            _bytes = static_cast<std::size_t>(file_info.st_size);
+            if (_bytes > 0) {
+                void* mapping = ::mmap(nullptr, _bytes, PROT_READ, MAP_PRIVATE,
+                                       fd, 0);
+                if (mapping == MAP_FAILED) {
+                    const int map_errno = errno;
+                    ::close(fd);
+                    throw std::system_error(map_errno, std::generic_category(),
+                                            "mmap " + path);
+                }
+                if (advice == mmap_advice::sequential)
+                    ::madvise(mapping, _bytes, MADV_SEQUENTIAL);
+                else if (advice == mmap_advice::willneed)
+                    ::madvise(mapping, _bytes, MADV_WILLNEED);
+                _data = static_cast<const T*>(mapping);
+                _count = _bytes / sizeof(T);
+            }
+            ::close(fd);  // the mapping keeps the file alive
+        }
+
+        Mmap_Range(const Mmap_Range&) = delete;
+        Mmap_Range& operator=(const Mmap_Range&) = delete;
+
+        Mmap_Range(Mmap_Range&& other)
+            : _data(other._data), _count(other._count), _bytes(other._bytes) {
+            other._data = nullptr;
+            other._count = 0;
+            other._bytes = 0;
+        }
+
+        Mmap_Range& operator=(Mmap_Range&& other) {
+            if (this != &other) {
+                unmap();
+                _data = other._data;
+                _count = other._count;
+                _bytes = other._bytes;
+                other._data = nullptr;
+                other._count = 0;
+                other._bytes = 0;
+            }
+            return *this;
+        }
+
+        ~Mmap_Range() {
+            unmap();
+        }
+
+        const_iterator begin() const {return _data;}
+        const_iterator end() const {return _data + _count;}
+
+        const T* data() const {return _data;}
+        std::size_t size() const {return _count;}
+        bool empty() const {return _count == 0;}
+
+        const T& operator[](std::size_t i) const {return _data[i];}
+
+    private:
+        void unmap() {
+            if (_data != nullptr)
+                ::munmap(const_cast<T*>(_data), _bytes);
+        }
+    };
+
+    /* The mmap wrapper function, mirroring range()/zip():
+     * mmap_range<float>("a.col") */
+    template<typename T>
+    Mmap_Range<T> mmap_range(const std::string& path,
+                             mmap_advice advice = mmap_advice::normal) {
+        return Mmap_Range<T>(path, advice);
+    }
+
+}
+#endif
@@ -0,0 +1,515 @@
+#ifndef _UTIL_PARALLEL_FOR_HPP_
+#define _UTIL_PARALLEL_FOR_HPP_
+
+/* Parallel loops and reductions over a Range, executed by a work-stealing
+ * thread pool.
+ *
+ * The range is split recursively in O(1) index arithmetic; each split point
+ * is aligned so neighbouring chunks do not share a cache line for typical
+ * element sizes. The calling thread takes part in the work, so the pool only
+ * keeps hardware_concurrency() - 1 extra threads.
+ *
+ * usage:
+ *     parallel_for(range(0, n), [&](std::size_t i) {
+ *         out[i] = f(in[i]);
+ *     });
+ *     // optional grainsize: no task runs fewer than 1024 iterations
+ *     parallel_for(range(0, n), body, 1024);
+ *
+ *     double total = parallel_reduce(range(0, n), 0.0,
+ *         [&](std::size_t i) { return score(i); },
+ *         [](double a, double b) { return a + b; });
+ *
+ * The default schedule splits recursively and lets idle threads steal.
+ * Call sites that know better can pick a policy:
+ *
+ *     // one contiguous page-aligned block per thread, workers pinned to
+ *     // cores - repeated loops touch the same pages from the same core,
+ *     // so first-touch placement keeps chunks node-local
+ *     parallel_for(range(0, n), body, schedule::static_blocks);
+ *
+ *     // shrinking chunks off a shared counter, for irregular bodies
+ *     parallel_for(range(0, n), body, schedule::guided);
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "range.hpp"
+
+namespace util {
+
+    /* A work-stealing thread pool, one deque per worker.
+     *
+     * Workers pop from the back of their own deque and steal from the front
+     * of the others, so a splitting task keeps its own cache-hot half and
+     * thieves take the biggest stolen pieces first.
+     */
+    class Thread_Pool {
+        struct Worker {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        std::vector<std::unique_ptr<Worker>> _workers;
+        std::vector<std::thread> _threads;
+        std::mutex _wake_mutex;
+        std::condition_variable _wake;
+        std::atomic<bool> _stop;
+        std::atomic<std::size_t> _queued;
+        std::atomic<std::size_t> _next_slot;
+        std::atomic<bool> _pinned;
+
+        /* Index of the current thread inside the pool, or a value past
+         * worker_count() for threads that are not pool workers. */
+        static std::size_t& worker_index() {
+            static thread_local std::size_t index = static_cast<std::size_t>(-1);
+            return index;
+        }
+
+        Thread_Pool() : _stop(false), _queued(0), _next_slot(0), _pinned(false) {
+            const unsigned hw = std::thread::hardware_concurrency();
+            const std::size_t count = hw > 1 ? hw - 1 : 0;
+            for (std::size_t i = 0; i < count; ++i)
+                _workers.emplace_back(new Worker());
+            for (std::size_t i = 0; i < count; ++i)
+                _threads.emplace_back([this, i] { worker_loop(i); });
+        }
+
+        ~Thread_Pool() {
+            // same discipline as submit(): the flag must flip under the
+            // wake mutex or a worker between predicate check and wait
+            // misses the notify and join() hangs
+            {
+                std::lock_guard<std::mutex> lock(_wake_mutex);
+                _stop = true;
+            }
+            _wake.notify_all();
+            for (std::thread& t : _threads)
+                t.join();
+        }
+
+        void worker_loop(std::size_t me) {
+            worker_index() = me;
+            while (!_stop) {
+                if (!try_run_one()) {
+                    std::unique_lock<std::mutex> lock(_wake_mutex);
+                    _wake.wait(lock, [this] { return _stop || _queued > 0; });
+                }
+            }
+        }
+
+    public:
+        Thread_Pool(const Thread_Pool&) = delete;
+        Thread_Pool& operator=(const Thread_Pool&) = delete;
+
+        /// The process-wide pool, created on first use
+        static Thread_Pool& instance() {
+            static Thread_Pool pool;
+            return pool;
+        }
+
+        /// Number of pool threads (the caller of parallel_for makes one more)
+        std::size_t worker_count() const {
+            return _workers.size();
+        }
+
+        /* Queue a task: on a worker thread it goes to the back of that
+         * worker's own deque, elsewhere to a round-robin victim. With no
+         * workers at all (hardware_concurrency() <= 1) the task runs
+         * inline - there is nobody to queue it for. */
+        void submit(std::function<void()> task) {
+            if (_workers.empty()) {
+                task();
+                return;
+            }
+            const std::size_t me = worker_index();
+            const std::size_t slot = me < _workers.size()
+                ? me
+                : _next_slot++ % _workers.size();
+            {
+                std::lock_guard<std::mutex> lock(_workers[slot]->mutex);
+                _workers[slot]->tasks.push_back(std::move(task));
+            }
+            // the increment must happen under the wake mutex: otherwise it
+            // can slip between a worker's predicate check and its wait,
+            // and the notify is lost
+            {
+                std::lock_guard<std::mutex> lock(_wake_mutex);
+                ++_queued;
+            }
+            _wake.notify_one();
+        }
+
+        /* Queue a task on a specific worker's deque. Thieves can still take
+         * it, so a targeted task is a placement hint, not a hard binding. */
+        void submit_to(std::size_t slot, std::function<void()> task) {
+            {
+                std::lock_guard<std::mutex> lock(_workers[slot]->mutex);
+                _workers[slot]->tasks.push_back(std::move(task));
+            }
+            {
+                std::lock_guard<std::mutex> lock(_wake_mutex);
+                ++_queued;
+            }
+            _wake.notify_one();
+        }
+
+        /* Pin worker i to core i + 1 (core 0 is left to the caller).
+         * Idempotent; a no-op off Linux. Pinned workers plus static blocks
+         * give first-touch page placement a stable core per chunk. */
+        void pin_workers() {
+#ifdef __linux__
+            if (_pinned.exchange(true))
+                return;
+            const unsigned hw = std::thread::hardware_concurrency();
+            for (std::size_t i = 0; i < _threads.size(); ++i) {
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                CPU_SET((i + 1) % hw, &set);
+                pthread_setaffinity_np(_threads[i].native_handle(),
+                                       sizeof(set), &set);
+            }
+#endif
+        }
+
+        /// Run one task, own deque first, then steal. Returns false if idle.
+        bool try_run_one() {
+            std::function<void()> task;
+            const std::size_t me = worker_index();
+            if (me < _workers.size()) {
+                Worker& own = *_workers[me];
+                std::lock_guard<std::mutex> lock(own.mutex);
+                if (!own.tasks.empty()) {
+                    task = std::move(own.tasks.back());
+                    own.tasks.pop_back();
+                }
+            }
+            for (std::size_t k = 0; !task && k < _workers.size(); ++k) {
+                Worker& victim = *_workers[(me + 1 + k) % _workers.size()];
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                if (!victim.tasks.empty()) {
+                    task = std::move(victim.tasks.front());
+                    victim.tasks.pop_front();
+                }
+            }
+            if (!task)
+                return false;
+            --_queued;
+            task();
+            return true;
+        }
+
+        /// Help run tasks until counter reaches target (used by the caller)
+        void wait_for(const std::atomic<std::size_t>& counter, std::size_t target) {
+            while (counter.load(std::memory_order_acquire) < target) {
+                if (!try_run_one())
+                    std::this_thread::yield();
+            }
+        }
+    };
+
+    /** Per-call-site scheduling policy for parallel_for
+     *
+     * dynamic_steal  recursive splitting, idle threads steal; the default,
+     *                best when nothing is known about the body
+     * static_blocks  one contiguous block per thread, boundaries aligned to
+     *                page multiples, workers pinned to cores; chunk k always
+     *                runs on core k, so pages first-touched by a loop stay
+     *                local to the core (and NUMA node) that re-reads them
+     * guided         shrinking chunks handed out from a shared counter;
+     *                balances irregular bodies without the splitting tree
+     */
+    enum class schedule { dynamic_steal, static_blocks, guided };
+
+    namespace parallel_impl {
+
+        /* Split points and grain sizes are rounded to this many indices so
+         * adjacent chunks land on separate cache lines for elements of 4
+         * bytes and up. */
+        constexpr std::size_t chunk_align = 16;
+
+        /* Static block boundaries snap to this many indices: one 4 KiB page
+         * of 8-byte elements, so a block's pages are not shared with the
+         * neighbouring block for any element of 8 bytes and up. */
+        constexpr std::size_t page_chunk_align = 4096 / 8;
+
+        inline std::size_t align_up(std::size_t n) {
+            return (n + chunk_align - 1) / chunk_align * chunk_align;
+        }
+
+        inline std::size_t default_grainsize(std::size_t n, std::size_t threads) {
+            // 4 chunks per thread leaves room for stealing without drowning
+            // the deques in tiny tasks
+            const std::size_t grain = n / (4 * threads);
+            return grain < chunk_align ? chunk_align : align_up(grain);
+        }
+
+        /* One parallel loop in flight: splits [lo, hi) in halves, queues the
+         * upper halves and keeps descending into the lower one. */
+        template<class Iterator, class Function>
+        struct For_Job {
+            Iterator first;  // iterator at loop index 0
+            Function* fn;
+            std::size_t grainsize;
+            std::atomic<std::size_t>* done;
+            Thread_Pool* pool;
+
+            void run(std::size_t lo, std::size_t hi) const {
+                while (hi - lo > grainsize) {
+                    std::size_t mid = lo + align_up((hi - lo) / 2);
+                    if (mid >= hi)
+                        mid = lo + (hi - lo) / 2;
+                    For_Job self = *this;
+                    pool->submit([self, mid, hi] { self.run(mid, hi); });
+                    hi = mid;
+                }
+                Iterator it = first + static_cast<std::ptrdiff_t>(lo);
+                for (std::size_t i = lo; i < hi; ++i, ++it)
+                    (*fn)(*it);
+                done->fetch_add(hi - lo, std::memory_order_acq_rel);
+            }
+        };
+    }
+
+    namespace parallel_impl {
+
+        /* One parallel reduction in flight. Each node of the recursion owns
+         * a private accumulator (no atomics on the element path), queues the
+         * upper half, descends into the lower one, then combines the two
+         * results - a combination tree mirroring the split tree. */
+        template<class Iterator, class Value, class Map, class Combine>
+        struct Reduce_Job {
+            Iterator first;  // iterator at loop index 0
+            const Value* identity;
+            Map* map;
+            Combine* combine;
+            std::size_t grainsize;
+            Thread_Pool* pool;
+
+            Value run(std::size_t lo, std::size_t hi) const {
+                if (hi - lo <= grainsize) {
+                    Value acc = *identity;
+                    Iterator it = first + static_cast<std::ptrdiff_t>(lo);
+                    for (std::size_t i = lo; i < hi; ++i, ++it)
+                        acc = (*combine)(acc, (*map)(*it));
+                    return acc;
+                }
+                std::size_t mid = lo + align_up((hi - lo) / 2);
+                if (mid >= hi)
+                    mid = lo + (hi - lo) / 2;
+
+                Value right = *identity;
+                std::atomic<bool> right_done(false);
+                const Reduce_Job* self = this;
+                pool->submit([self, mid, hi, &right, &right_done] {
+                    right = self->run(mid, hi);
+                    right_done.store(true, std::memory_order_release);
+                });
+                Value left = run(lo, mid);
+                // help with other tasks while the stolen half is in flight
+                while (!right_done.load(std::memory_order_acquire)) {
+                    if (!pool->try_run_one())
+                        std::this_thread::yield();
+                }
+                return (*combine)(left, right);
+            }
+        };
+    }
+
+    /* Apply fn to every value of the loop range, on all cores.
+     *
+     * Blocks until the whole range has been processed; the calling thread
+     * executes chunks too. grainsize caps how small a chunk may get, 0 picks
+     * a size that feeds every thread a handful of chunks.
+     */
+    template<typename IntegerType, class Function>
+    void parallel_for(Range<IntegerType> loop, Function&& fn,
+                      std::size_t grainsize = 0) {
+        auto first = loop.begin();
+        const std::ptrdiff_t extent = loop.end() - first;
+        if (extent <= 0)
+            return;
+        const std::size_t n = static_cast<std::size_t>(extent);
+
+        Thread_Pool& pool = Thread_Pool::instance();
+        if (grainsize == 0)
+            grainsize = parallel_impl::default_grainsize(n, pool.worker_count() + 1);
+        if (grainsize < loop.grainsize())
+            grainsize = loop.grainsize();  // the range's own knob wins
+
+        // Indexed loops throughout: comparing against an off-grid end value
+        // with != would overshoot when the pace does not divide the extent
+        if (n <= grainsize || pool.worker_count() == 0) {
+            for (std::size_t i = 0; i < n; ++i)
+                fn(first[i]);
+            return;
+        }
+
+        std::atomic<std::size_t> done(0);
+        parallel_impl::For_Job<decltype(first), typename std::remove_reference<Function>::type>
+            job{first, &fn, grainsize, &done, &pool};
+        job.run(0, n);
+        pool.wait_for(done, n);
+    }
+
+    namespace parallel_impl {
+
+        /* Shared claim state of a guided loop. Heap-allocated and owned by
+         * every participant: a straggler task may inspect the counters after
+         * the caller has already seen the loop complete and returned. */
+        struct Guided_State {
+            std::atomic<std::size_t> next;
+            std::atomic<std::size_t> done;
+            Guided_State() : next(0), done(0) {}
+        };
+    }
+
+    /* parallel_for with an explicit scheduling policy.
+     *
+     * static_blocks cuts the range into one contiguous block per thread,
+     * snaps the boundaries to page multiples and pins the pool workers to
+     * cores; block k is queued on worker k every time, so a loop that runs
+     * repeatedly touches each page from the same core and first-touch
+     * placement keeps the block's pages node-local. guided hands out
+     * shrinking chunks from a shared counter - late chunks are small, so an
+     * irregular body ends nearly even. dynamic_steal is the default engine.
+     */
+    template<typename IntegerType, class Function>
+    void parallel_for(Range<IntegerType> loop, Function&& fn,
+                      schedule policy, std::size_t grainsize = 0) {
+        if (policy == schedule::dynamic_steal) {
+            parallel_for(loop, std::forward<Function>(fn), grainsize);
+            return;
+        }
+        auto first = loop.begin();
+        const std::ptrdiff_t extent = loop.end() - first;
+        if (extent <= 0)
+            return;
+        const std::size_t n = static_cast<std::size_t>(extent);
+
+        Thread_Pool& pool = Thread_Pool::instance();
+        const std::size_t parts = pool.worker_count() + 1;
+        if (grainsize < loop.grainsize())
+            grainsize = loop.grainsize();
+
+        if (pool.worker_count() == 0 || n <= grainsize
+            || (policy == schedule::static_blocks && n < parts)) {
+            for (std::size_t i = 0; i < n; ++i)
+                fn(first[i]);
+            return;
+        }
+
+        auto* fn_ptr = &fn;
+
+        if (policy == schedule::static_blocks) {
+            pool.pin_workers();
+            std::size_t block = (n + parts - 1) / parts;
+            block = (block + parallel_impl::page_chunk_align - 1)
+                / parallel_impl::page_chunk_align
+                * parallel_impl::page_chunk_align;
+
+            std::atomic<std::size_t> done(0);
+            std::size_t caller_lo = 0;
+            std::size_t caller_hi = block < n ? block : n;
+            // block 0 runs on the caller, block b on pinned worker b - 1
+            for (std::size_t b = 1; b * block < n; ++b) {
+                const std::size_t lo = b * block;
+                const std::size_t hi = lo + block < n ? lo + block : n;
+                pool.submit_to(b - 1, [first, fn_ptr, lo, hi, &done] {
+                    auto it = first + static_cast<std::ptrdiff_t>(lo);
+                    for (std::size_t i = lo; i < hi; ++i, ++it)
+                        (*fn_ptr)(*it);
+                    done.fetch_add(hi - lo, std::memory_order_acq_rel);
+                });
+            }
+            for (std::size_t i = caller_lo; i < caller_hi; ++i)
+                fn(first[i]);
+            done.fetch_add(caller_hi - caller_lo, std::memory_order_acq_rel);
+            pool.wait_for(done, n);
+            return;
+        }
+
+        // guided
+        if (grainsize < parallel_impl::chunk_align)
+            grainsize = parallel_impl::chunk_align;
+        auto state = std::make_shared<parallel_impl::Guided_State>();
+        auto worker = [state, first, fn_ptr, n, parts, grainsize] {
+            for (;;) {
+                const std::size_t seen =
+                    state->next.load(std::memory_order_relaxed);
+                if (seen >= n)
+                    break;
+                std::size_t chunk = (n - seen) / (2 * parts);
+                if (chunk < grainsize)
+                    chunk = grainsize;
+                const std::size_t lo =
+                    state->next.fetch_add(chunk, std::memory_order_acq_rel);
+                if (lo >= n)
+                    break;
+                const std::size_t hi = lo + chunk < n ? lo + chunk : n;
+                auto it = first + static_cast<std::ptrdiff_t>(lo);
+                for (std::size_t i = lo; i < hi; ++i, ++it)
+                    (*fn_ptr)(*it);
+                state->done.fetch_add(hi - lo, std::memory_order_acq_rel);
+            }
+        };
+        for (std::size_t w = 0; w < pool.worker_count(); ++w)
+            pool.submit(worker);
+        worker();
+        pool.wait_for(state->done, n);
+    }
+
+    /* Parallel reduction: combine(acc, map_fn(i)) over every value of the
+     * loop range.
+     *
+     * The range is split recursively; every subtask keeps a private
+     * accumulator seeded with identity and results are merged in a tree, so
+     * the element path touches no atomics and accumulators never share a
+     * cache line. combine_fn must be associative, and identity its neutral
+     * element.
+     */
+    template<typename IntegerType, class Value, class Map, class Combine>
+    Value parallel_reduce(Range<IntegerType> loop, Value identity,
+                          Map&& map_fn, Combine&& combine_fn,
+                          std::size_t grainsize = 0) {
+        auto first = loop.begin();
+        const std::ptrdiff_t extent = loop.end() - first;
+        if (extent <= 0)
+            return identity;
+        const std::size_t n = static_cast<std::size_t>(extent);
+
+        Thread_Pool& pool = Thread_Pool::instance();
+        if (grainsize == 0)
+            grainsize = parallel_impl::default_grainsize(n, pool.worker_count() + 1);
+        if (grainsize < loop.grainsize())
+            grainsize = loop.grainsize();
+
+        if (n <= grainsize || pool.worker_count() == 0) {
+            Value acc = identity;
+            for (std::size_t i = 0; i < n; ++i)
+                acc = combine_fn(acc, map_fn(first[i]));
+            return acc;
+        }
+
+        parallel_impl::Reduce_Job<decltype(first), Value,
+                                  typename std::remove_reference<Map>::type,
+                                  typename std::remove_reference<Combine>::type>
+            job{first, &identity, &map_fn, &combine_fn, grainsize, &pool};
+        return job.run(0, n);
+    }
+}
+#endif
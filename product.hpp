@@ -0,0 +1,181 @@
+#ifndef _UTIL_PRODUCT_HPP_
+#define _UTIL_PRODUCT_HPP_
+
+/* An all-pairs companion to zip: iterate every (x, y) combination of two
+ * iterables.
+ *
+ * product(a, b) walks row-major (all of b for each element of a);
+ * product(a, b).tiled(BI, BJ) walks the same pairs in BI x BJ blocks of the
+ * index space, so the inner container is reused from L1/L2 instead of being
+ * streamed from memory once per outer element. Tiled traversal needs random
+ * access containers.
+ *
+ * usage:
+ *     for(auto&& [x, y] : product(queries, documents).tiled(64, 512))
+ *         score(x, y);
+ */
+
+#include <cstddef>
+#include <iterator>
+#include <tuple>
+
+#include "range2d.hpp"
+#include "zip.hpp"
+
+namespace util {
+
+    template<class A, class B>
+    class product_tiled_impl;
+
+    /** Row-major all-pairs view over two iterables
+     *
+     * \tparam A,B The wrapped iterable types, references for lvalue
+     *         arguments (rvalues are owned, like zip).
+     */
+    template<class A, class B>
+    class product_impl {
+    public:
+        using iterator_a = typename iterator_extractor<A>::type;
+        using iterator_b = typename iterator_extractor<B>::type;
+        /// Pair of element references, same shape as zip's reference_tuple
+        using reference = std::tuple<typename reference_extractor<A>::type,
+                                     typename reference_extractor<B>::type>;
+        using const_reference = reference;
+
+        class iterator {
+            iterator_a _a;
+            iterator_b _b;
+            iterator_b _b_begin;
+            iterator_b _b_end;
+        public:
+            iterator(iterator_a a, iterator_b b, iterator_b b_begin, iterator_b b_end)
+                : _a(a), _b(b), _b_begin(b_begin), _b_end(b_end) {}
+            iterator& operator++() {
+                if (++_b == _b_end) {
+                    _b = _b_begin;
+                    ++_a;
+                }
+                return *this;
+            }
+            reference operator*() const {
+                return reference(*_a, *_b);
+            }
+            bool operator==(const iterator& o) const {
+                return _a == o._a && _b == o._b;
+            }
+            bool operator!=(const iterator& o) const {
+                return ! (*this == o);
+            }
+        };
+
+        using const_iterator = iterator;
+
+        product_impl(A&& a, B&& b)
+            : _a(std::forward<A>(a)), _b(std::forward<B>(b)) {}
+
+        iterator begin() {
+            if (_a.begin() == _a.end() || _b.begin() == _b.end())
+                return end();
+            return iterator(_a.begin(), _b.begin(), _b.begin(), _b.end());
+        }
+
+        iterator end() {
+            return iterator(_a.end(), _b.begin(), _b.begin(), _b.end());
+        }
+
+        /* The same pairs in a blocked traversal order. The containers move
+         * on into the tiled view (lvalues stay referenced), so this chains
+         * off a temporary safely. */
+        product_tiled_impl<A, B> tiled(std::size_t tile_a, std::size_t tile_b) {
+            return product_tiled_impl<A, B>(std::forward<A>(_a),
+                                            std::forward<B>(_b),
+                                            tile_a, tile_b);
+        }
+
+    private:
+        A _a;
+        B _b;
+    };
+
+    /* The product wrapper function */
+    template<class A, class B>
+    auto product(A&& a, B&& b) -> product_impl<A, B> {
+        return product_impl<A, B>(std::forward<A>(a), std::forward<B>(b));
+    }
+
+
+    /** Tile-ordered all-pairs view
+     *
+     * Drives a Tiled_Range2d over the two sizes and dereferences through
+     * random access iterators, visiting the index space block by block so
+     * the inner elements of a block stay cache-resident across the outer
+     * elements of the same block.
+     */
+    template<class A, class B>
+    class product_tiled_impl {
+    public:
+        using iterator_a = typename iterator_extractor<A>::type;
+        using iterator_b = typename iterator_extractor<B>::type;
+        using reference = std::tuple<typename reference_extractor<A>::type,
+                                     typename reference_extractor<B>::type>;
+        using const_reference = reference;
+        using space_iterator = typename Tiled_Range2d<std::size_t>::Iterator;
+
+        class iterator {
+            space_iterator _ij;
+            iterator_a _a0;
+            iterator_b _b0;
+        public:
+            iterator(space_iterator ij, iterator_a a0, iterator_b b0)
+                : _ij(ij), _a0(a0), _b0(b0) {}
+            iterator& operator++() {
+                ++_ij;
+                return *this;
+            }
+            reference operator*() const {
+                std::size_t i, j;
+                std::tie(i, j) = *_ij;
+                return reference(_a0[static_cast<std::ptrdiff_t>(i)],
+                                 _b0[static_cast<std::ptrdiff_t>(j)]);
+            }
+            bool operator==(const iterator& o) const {
+                return _ij == o._ij;
+            }
+            bool operator!=(const iterator& o) const {
+                return ! (*this == o);
+            }
+        };
+
+        using const_iterator = iterator;
+
+        product_tiled_impl(A&& a, B&& b, std::size_t tile_a, std::size_t tile_b)
+            : _a(std::forward<A>(a)), _b(std::forward<B>(b)),
+              _space(static_cast<std::size_t>(std::distance(_a.begin(), _a.end())),
+                     static_cast<std::size_t>(std::distance(_b.begin(), _b.end())),
+                     tile_a, tile_b) {}
+
+        iterator begin() {
+            return iterator(_space.begin(), _a.begin(), _b.begin());
+        }
+
+        iterator end() {
+            return iterator(_space.end(), _a.begin(), _b.begin());
+        }
+
+    private:
+        A _a;
+        B _b;
+        Tiled_Range2d<std::size_t> _space;
+    };
+
+    /* Direct entry for the blocked order, equivalent to
+     * product(a, b).tiled(tile_a, tile_b) */
+    template<class A, class B>
+    auto product_tiled(A&& a, B&& b, std::size_t tile_a, std::size_t tile_b)
+        -> product_tiled_impl<A, B> {
+        return product_tiled_impl<A, B>(std::forward<A>(a), std::forward<B>(b),
+                                        tile_a, tile_b);
+    }
+
+}
+#endif
@@ -10,48 +10,92 @@
  *        std::cout << c << std::endl;
  */
 
+#include <array>
 #include <cstddef>
 #include <iterator>
+#include <type_traits>
 
 namespace util {
+
+    /* Tag asking the splitting constructor to cut a range in two.
+     * Same role as tbb::split; the splitting constructor also accepts
+     * tbb::split itself so Range can be handed to TBB without this header
+     * depending on TBB.
+     */
+    struct split {};
+
+    template<typename IntegerType, std::size_t W>
+    class Lane_Range;
+
+    template<typename IntegerType>
+    class Chunk_Range;
+
     /* A dummy container to create integer iterators */
     template<typename IntegerType = std::size_t>
     class Range {
         IntegerType _start;
         IntegerType _end;
         IntegerType _pace;
+        std::size_t _grainsize = 1;
     public:
 
-        /* Integer iterator */
+        /* Integer iterator
+         *
+         * Advertises itself as random access so standard algorithms
+         * (std::distance, std::for_each with execution policies, ...) pick
+         * their O(1) paths instead of stepping one element at a time.
+         */
         class Iterator {
         protected:
             IntegerType _val = 0;
             IntegerType _pace = 1;
         public:
-            Iterator() {}
-            Iterator(IntegerType val, IntegerType pace = 1) : _val(val), _pace(pace) {}
-            IntegerType& operator*() {return _val;}
-            IntegerType operator*() const {return this->_val;}
-            Iterator& operator+=(const std::size_t n)    {_val += n*_pace; return *this;}
-            Iterator& operator++()    {return (*this) += 1;}
-            Iterator  operator++(int) {Iterator tmp = *this; ++(*this); return tmp;}
-            friend Iterator  operator+(Iterator lhs, const std::size_t& n) { return lhs += n;}
-            Iterator& operator-=(const std::size_t n)    {_val -= n*_pace; return *this;}
-            Iterator& operator--()    {return *this -= 1;}
-            Iterator  operator--(int) {Iterator tmp = *this; --(*this); return tmp;}
-            friend Iterator  operator-(Iterator lhs, const std::size_t& n) { return lhs -= n;}
-            bool operator==(const Iterator& o) const {return _val == o._val;}
-            bool operator!=(const Iterator& o) const {return ! (*this == o);}
-            bool operator<(const Iterator& o) const {return _val < o._val;}
-            bool operator>(const Iterator& o) const {return o < *this;}
-            bool operator>=(const Iterator& o) const {return ! (*this < o);}
-            bool operator<=(const Iterator& o) const {return ! (o < *this);}
+            /// Standard iterator typedefs
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = IntegerType;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const IntegerType*;
+            // Dereference yields a value: the iterator generates its integers,
+            // it does not point into storage. A value is also what the C++20
+            // random_access_iterator concept needs here (const and non-const
+            // dereference must agree).
+            using reference = IntegerType;
+
+            Iterator() noexcept {}
+            Iterator(IntegerType val, IntegerType pace = 1) noexcept : _val(val), _pace(pace) {}
+            IntegerType operator*() const noexcept {return this->_val;}
+            IntegerType operator[](const difference_type n) const noexcept {return _val + n*_pace;}
+            Iterator& operator+=(const difference_type n) noexcept    {_val += n*_pace; return *this;}
+            Iterator& operator++() noexcept    {return (*this) += 1;}
+            Iterator  operator++(int) noexcept {Iterator tmp = *this; ++(*this); return tmp;}
+            friend Iterator  operator+(Iterator lhs, const difference_type& n) noexcept { return lhs += n;}
+            friend Iterator  operator+(const difference_type& n, Iterator rhs) noexcept { return rhs += n;}
+            Iterator& operator-=(const difference_type n) noexcept    {_val -= n*_pace; return *this;}
+            Iterator& operator--() noexcept    {return *this -= 1;}
+            Iterator  operator--(int) noexcept {Iterator tmp = *this; --(*this); return tmp;}
+            friend Iterator  operator-(Iterator lhs, const difference_type& n) noexcept { return lhs -= n;}
+            /// Distance between two iterators, in steps of the common pace.
+            /// Rounded away from zero so begin()/end() of a strided range
+            /// give the actual trip count even when the end value is not on
+            /// the stride grid.
+            friend difference_type operator-(const Iterator& lhs, const Iterator& rhs) noexcept {
+                const difference_type d = static_cast<difference_type>(lhs._val)
+                    - static_cast<difference_type>(rhs._val);
+                const difference_type p = static_cast<difference_type>(lhs._pace);
+                return d >= 0 ? (d + p - 1) / p : -((-d + p - 1) / p);
+            }
+            bool operator==(const Iterator& o) const noexcept {return _val == o._val;}
+            bool operator!=(const Iterator& o) const noexcept {return ! (*this == o);}
+            bool operator<(const Iterator& o) const noexcept {return _val < o._val;}
+            bool operator>(const Iterator& o) const noexcept {return o < *this;}
+            bool operator>=(const Iterator& o) const noexcept {return ! (*this < o);}
+            bool operator<=(const Iterator& o) const noexcept {return ! (o < *this);}
         };
 
         class Const_Iterator : public Iterator {
         public:
             using Iterator::Iterator;
-            const IntegerType& operator*() const {return this->val;}
+            IntegerType operator*() const noexcept {return this->_val;}
         };
 
         /// Integer type used to generate the range
@@ -60,45 +104,252 @@ namespace util {
         using iterator = Iterator;
         /// Const iterator type
         using const_iterator = Const_Iterator;
-        // Reference to pointed type
-        using reference = IntegerType&;
-        // Const reference to pointed type
-        using const_reference = const IntegerType&;
+        // "Reference" to pointed type: a value, matching what the iterators
+        // produce - the range generates integers, it does not store them
+        using reference = IntegerType;
+        // Const variant, also a value
+        using const_reference = IntegerType;
 
-        Range(const IntegerType& start, const IntegerType& end, const IntegerType& pace = 1)
-            : _start(start), _end(end), _pace(pace){}
+        Range(const IntegerType& start, const IntegerType& end, const IntegerType& pace = 1,
+              std::size_t grainsize = 1)
+            : _start(start), _end(end), _pace(pace), _grainsize(grainsize) {}
 
         template<class T, class iterator = typename T::iterator>
         Range(const T& iterable) :  Range(0, std::distance(iterable.begin(), iterable.end()), 1) {}
 
-        iterator begin() {
-            return Iterator{_start, _pace};
+        /* Splitting constructor: takes the upper half of other and shrinks
+         * other to the lower half, cutting on the stride grid. Together with
+         * size(), empty() and is_divisible() this models the TBB splittable
+         * range concept, so a Range flows into tbb::parallel_for/reduce
+         * call sites as-is. Templated on the tag so both util::split and
+         * tbb::split are accepted.
+         */
+        template<class Split,
+                 typename std::enable_if<std::is_empty<Split>::value, int>::type = 0>
+        Range(Range& other, const Split&)
+            : _start(other._start
+                     + static_cast<IntegerType>(other.size() / 2) * other._pace),
+              _end(other._end), _pace(other._pace), _grainsize(other._grainsize) {
+            other._end = _start;
         }
 
-        const_iterator begin() const {
+        /// Number of iterations the range performs
+        std::size_t size() const noexcept {
+            if (!(_start < _end))
+                return 0;
+            return (static_cast<std::size_t>(_end - _start)
+                    + static_cast<std::size_t>(_pace) - 1)
+                / static_cast<std::size_t>(_pace);
+        }
+
+        bool empty() const noexcept {
+            return size() == 0;
+        }
+
+        /// True when the range is worth splitting further
+        bool is_divisible() const noexcept {
+            return size() > _grainsize;
+        }
+
+        /// Minimum iteration count a split may produce
+        std::size_t grainsize() const noexcept {
+            return _grainsize;
+        }
+
+        iterator begin() noexcept {
             return Iterator{_start, _pace};
         }
 
-        iterator end() {
-            return Iterator{_end, _pace};
+        const_iterator begin() const noexcept {
+            return Const_Iterator{_start, _pace};
         }
 
-        const_iterator end() const {
+        iterator end() noexcept {
             return Iterator{_end, _pace};
         }
 
-        iterator rbegin() {
+        const_iterator end() const noexcept {
+            return Const_Iterator{_end, _pace};
+        }
+
+        iterator rbegin() noexcept {
             return --end();
         }
 
-        iterator rend() {
+        iterator rend() noexcept {
             return --begin();
         }
+
+        /* Strip-mined view of the range: whole packs of W indices per step,
+         * with the tail available from remainder(). One loop header replaces
+         * the hand-written main-vector-loop plus epilogue pattern.
+         */
+        template<std::size_t W>
+        Lane_Range<IntegerType, W> lanes() const {
+            return Lane_Range<IntegerType, W>(_start, _end, _pace);
+        }
+
+        /* Batch view of the range: subranges of at most chunk_size
+         * iterations each, the unit of dispatch for thread pools and
+         * batched I/O. Chunk count and random access are O(1).
+         */
+        Chunk_Range<IntegerType> chunks(std::size_t chunk_size) const {
+            return Chunk_Range<IntegerType>(_start, _end, _pace, chunk_size);
+        }
+    };
+
+
+    /** Subrange view over a Range
+     *
+     * Iteration yields Range values covering chunk_size iterations each
+     * (the last chunk may be shorter), every one carrying the correct
+     * start/end/pace so it can be iterated or handed to parallel_for
+     * directly.
+     *
+     * usage:
+     *     for(auto batch : range(0, n).chunks(B))
+     *         writer.put(batch);       // each batch is a Range
+     *     auto third = range(0, n).chunks(B)[2];  // O(1) random access
+     */
+    template<typename IntegerType>
+    class Chunk_Range {
+        IntegerType _start;
+        IntegerType _pace;
+        std::size_t _count;  // total trip count of the underlying range
+        std::size_t _chunk;  // iterations per chunk
+    public:
+        using value_type = Range<IntegerType>;
+
+        Chunk_Range(IntegerType start, IntegerType end, IntegerType pace,
+                    std::size_t chunk_size)
+            : _start(start), _pace(pace),
+              _count(Range<IntegerType>(start, end, pace).size()),
+              _chunk(chunk_size > 0 ? chunk_size : 1) {}
+
+        /// Number of chunks, O(1)
+        std::size_t size() const noexcept {
+            return (_count + _chunk - 1) / _chunk;
+        }
+
+        /// Chunk number k, O(1)
+        Range<IntegerType> operator[](std::size_t k) const {
+            const std::size_t lo = k * _chunk;
+            const std::size_t hi = lo + _chunk < _count ? lo + _chunk : _count;
+            return Range<IntegerType>(
+                _start + static_cast<IntegerType>(lo) * _pace,
+                _start + static_cast<IntegerType>(hi) * _pace,
+                _pace);
+        }
+
+        /* Chunk iterator: an index into the chunk sequence */
+        class Iterator {
+            const Chunk_Range* _parent = nullptr;
+            std::size_t _k = 0;
+        public:
+            Iterator() {}
+            Iterator(const Chunk_Range* parent, std::size_t k)
+                : _parent(parent), _k(k) {}
+            Range<IntegerType> operator*() const {
+                return (*_parent)[_k];
+            }
+            Iterator& operator++() {
+                ++_k;
+                return *this;
+            }
+            bool operator==(const Iterator& o) const {return _k == o._k;}
+            bool operator!=(const Iterator& o) const {return ! (*this == o);}
+        };
+
+        using iterator = Iterator;
+
+        iterator begin() const {
+            return Iterator(this, 0);
+        }
+
+        iterator end() const {
+            return Iterator(this, size());
+        }
+    };
+
+
+    /** Vector-width pack view over a Range
+     *
+     * Iteration yields std::array<IntegerType, W> packs of W consecutive
+     * range values; only whole packs are produced, the scalar tail is
+     * exposed as a Range through remainder().
+     *
+     * usage:
+     *     auto lanes = range(n).lanes<8>();
+     *     for(auto pack : lanes)
+     *         process8(pack);           // std::array<std::size_t, 8>
+     *     for(auto i : lanes.remainder())
+     *         process1(i);              // up to 7 leftover indices
+     */
+    template<typename IntegerType, std::size_t W>
+    class Lane_Range {
+        static_assert(W > 0, "a pack holds at least one lane");
+        IntegerType _start;
+        IntegerType _pace;
+        std::size_t _count;  // total trip count of the underlying range
+        std::size_t _full;   // indices covered by whole packs
+    public:
+        /// One pack of W range values
+        using pack_type = std::array<IntegerType, W>;
+
+        Lane_Range(IntegerType start, IntegerType end, IntegerType pace)
+            : _start(start), _pace(pace),
+              _count(Range<IntegerType>(start, end, pace).size()),
+              _full(_count / W * W) {}
+
+        /* Pack iterator: advances W grid steps at a time */
+        class Iterator {
+            IntegerType _val = 0;
+            IntegerType _pace = 1;
+        public:
+            Iterator() {}
+            Iterator(IntegerType val, IntegerType pace) : _val(val), _pace(pace) {}
+            pack_type operator*() const {
+                pack_type pack;
+                for (std::size_t w = 0; w < W; ++w)
+                    pack[w] = _val + static_cast<IntegerType>(w) * _pace;
+                return pack;
+            }
+            Iterator& operator++() {
+                _val += static_cast<IntegerType>(W) * _pace;
+                return *this;
+            }
+            bool operator==(const Iterator& o) const {return _val == o._val;}
+            bool operator!=(const Iterator& o) const {return ! (*this == o);}
+        };
+
+        using iterator = Iterator;
+
+        iterator begin() const {
+            return Iterator(_start, _pace);
+        }
+
+        iterator end() const {
+            return Iterator(_start + static_cast<IntegerType>(_full) * _pace, _pace);
+        }
+
+        /// Number of whole packs
+        std::size_t size() const noexcept {
+            return _full / W;
+        }
+
+        /// The scalar tail after the last whole pack, possibly empty
+        Range<IntegerType> remainder() const {
+            return Range<IntegerType>(
+                _start + static_cast<IntegerType>(_full) * _pace,
+                _start + static_cast<IntegerType>(_count) * _pace,
+                _pace);
+        }
     };
 
     template <typename IntegerType = std::size_t>
-    Range<IntegerType> range(IntegerType start, IntegerType end, IntegerType pace = 1) {
-        return Range<IntegerType>(start, end, pace);
+    Range<IntegerType> range(IntegerType start, IntegerType end, IntegerType pace = 1,
+                             std::size_t grainsize = 1) {
+        return Range<IntegerType>(start, end, pace, grainsize);
     }
 
     template <typename IntegerType = std::size_t>
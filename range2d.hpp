@@ -0,0 +1,192 @@
+#ifndef _UTIL_RANGE2D_HPP_
+#define _UTIL_RANGE2D_HPP_
+
+/* A two-dimensional sibling of Range for matrix traversal.
+ *
+ * range2d(rows, cols) yields (i, j) index tuples in row-major order;
+ * range2d(rows, cols).tiled(TI, TJ) yields the same index space in
+ * TI x TJ cache-sized tiles, so column-heavy access patterns stop
+ * thrashing cache without four hand-written nested loops.
+ *
+ * usage:
+ *     for(auto ij : range2d(rows, cols).tiled(64, 64)) {
+ *         std::size_t i, j;
+ *         std::tie(i, j) = ij;
+ *         c[i][j] += a[i][k] * b[k][j];
+ *     }
+ */
+
+#include <cstddef>
+#include <tuple>
+
+#include "range.hpp"
+
+namespace util {
+
+    template<typename IntegerType>
+    class Tiled_Range2d;
+
+    /** Row-major (i, j) index space */
+    template<typename IntegerType = std::size_t>
+    class Range2d {
+        IntegerType _rows;
+        IntegerType _cols;
+    public:
+        /// The (i, j) tuple handed to the loop body
+        using value_type = std::tuple<IntegerType, IntegerType>;
+
+        /* Row-major index iterator */
+        class Iterator {
+            IntegerType _i = 0;
+            IntegerType _j = 0;
+            IntegerType _cols = 0;
+        public:
+            Iterator() {}
+            Iterator(IntegerType i, IntegerType j, IntegerType cols)
+                : _i(i), _j(j), _cols(cols) {}
+            value_type operator*() const {
+                return value_type(_i, _j);
+            }
+            Iterator& operator++() {
+                if (++_j == _cols) {
+                    _j = 0;
+                    ++_i;
+                }
+                return *this;
+            }
+            bool operator==(const Iterator& o) const {
+                return _i == o._i && _j == o._j;
+            }
+            bool operator!=(const Iterator& o) const {
+                return ! (*this == o);
+            }
+        };
+
+        using iterator = Iterator;
+
+        Range2d(IntegerType rows, IntegerType cols) : _rows(rows), _cols(cols) {}
+
+        iterator begin() const {
+            if (_rows == 0 || _cols == 0)
+                return end();
+            return Iterator(0, 0, _cols);
+        }
+
+        iterator end() const {
+            return Iterator(_rows, 0, _cols);
+        }
+
+        /// Total number of (i, j) pairs
+        std::size_t size() const {
+            return static_cast<std::size_t>(_rows) * static_cast<std::size_t>(_cols);
+        }
+
+        /// The same index space, walked in TI x TJ tiles
+        Tiled_Range2d<IntegerType> tiled(IntegerType tile_rows,
+                                         IntegerType tile_cols) const {
+            return Tiled_Range2d<IntegerType>(_rows, _cols, tile_rows, tile_cols);
+        }
+    };
+
+
+    /** Tile-ordered (i, j) index space
+     *
+     * Walks the rows x cols space tile by tile, row-major across tiles and
+     * row-major inside each tile. Edge tiles are clipped to the bounds.
+     */
+    template<typename IntegerType>
+    class Tiled_Range2d {
+        IntegerType _rows;
+        IntegerType _cols;
+        IntegerType _tile_rows;
+        IntegerType _tile_cols;
+
+        static IntegerType min(IntegerType a, IntegerType b) {
+            return a < b ? a : b;
+        }
+    public:
+        using value_type = std::tuple<IntegerType, IntegerType>;
+
+        /* Tile-order iterator: (_base_i, _base_j) is the current tile
+         * origin, (_i, _j) the position inside it. */
+        class Iterator {
+            IntegerType _base_i = 0;
+            IntegerType _base_j = 0;
+            IntegerType _i = 0;
+            IntegerType _j = 0;
+            IntegerType _rows = 0;
+            IntegerType _cols = 0;
+            IntegerType _tile_rows = 1;
+            IntegerType _tile_cols = 1;
+        public:
+            Iterator() {}
+            Iterator(IntegerType base_i, IntegerType rows, IntegerType cols,
+                     IntegerType tile_rows, IntegerType tile_cols)
+                : _base_i(base_i), _i(base_i), _rows(rows), _cols(cols),
+                  _tile_rows(tile_rows), _tile_cols(tile_cols) {}
+
+            value_type operator*() const {
+                return value_type(_i, _j);
+            }
+
+            Iterator& operator++() {
+                if (++_j < Tiled_Range2d::min(_base_j + _tile_cols, _cols))
+                    return *this;
+                _j = _base_j;
+                if (++_i < Tiled_Range2d::min(_base_i + _tile_rows, _rows))
+                    return *this;
+                // next tile to the right
+                _base_j += _tile_cols;
+                _i = _base_i;
+                _j = _base_j;
+                if (_base_j < _cols)
+                    return *this;
+                // next row of tiles
+                _base_i += _tile_rows;
+                if (_base_i > _rows)
+                    _base_i = _rows;  // normalize overshoot onto the end state
+                _base_j = 0;
+                _i = _base_i;
+                _j = 0;
+                return *this;
+            }
+
+            bool operator==(const Iterator& o) const {
+                return _base_i == o._base_i && _base_j == o._base_j
+                    && _i == o._i && _j == o._j;
+            }
+            bool operator!=(const Iterator& o) const {
+                return ! (*this == o);
+            }
+        };
+
+        using iterator = Iterator;
+
+        Tiled_Range2d(IntegerType rows, IntegerType cols,
+                      IntegerType tile_rows, IntegerType tile_cols)
+            : _rows(rows), _cols(cols),
+              _tile_rows(tile_rows > 0 ? tile_rows : 1),
+              _tile_cols(tile_cols > 0 ? tile_cols : 1) {}
+
+        iterator begin() const {
+            if (_rows == 0 || _cols == 0)
+                return end();
+            return Iterator(0, _rows, _cols, _tile_rows, _tile_cols);
+        }
+
+        iterator end() const {
+            return Iterator(_rows, _rows, _cols, _tile_rows, _tile_cols);
+        }
+
+        std::size_t size() const {
+            return static_cast<std::size_t>(_rows) * static_cast<std::size_t>(_cols);
+        }
+    };
+
+    template<typename IntegerType = std::size_t>
+    Range2d<IntegerType> range2d(IntegerType rows, IntegerType cols) {
+        return Range2d<IntegerType>(rows, cols);
+    }
+
+}
+#endif
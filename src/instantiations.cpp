@@ -0,0 +1,20 @@
+/* Explicit instantiation definitions matching instantiations.hpp: the
+ * one place these common specializations are compiled. */
+
+#include <cstddef>
+#include <vector>
+
+#include "../range.hpp"
+#include "../zip.hpp"
+
+namespace util {
+
+    template class Range<std::size_t>;
+    template class Range<int>;
+
+    template class zip_iterator<std::vector<double>&, std::vector<double>&>;
+    template struct zip_impl<std::vector<double>&, std::vector<double>&>;
+    template class zip_iterator<std::vector<float>&, std::vector<float>&>;
+    template struct zip_impl<std::vector<float>&, std::vector<float>&>;
+
+}
@@ -0,0 +1,74 @@
+#ifndef _UTIL_STATIC_RANGE_HPP_
+#define _UTIL_STATIC_RANGE_HPP_
+
+/* A compile-time sibling of Range for small fixed trip counts.
+ *
+ * template_for<N>(fn) expands fn over the indices 0..N-1 at compile time:
+ * the body is unrolled by construction, not by optimizer goodwill, and each
+ * index arrives as a std::integral_constant so it can be used as a template
+ * argument inside the body.
+ *
+ * usage:
+ *     template_for<4>([&](auto lane) {
+ *         acc[lane] += std::get<lane>(inputs);  // lane is a constant
+ *     });
+ *     static_range<8>::for_each([&](auto i) { ... });
+ */
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace util {
+
+    /* This structure builds a compile-time index pack 0..N-1.
+     * std::index_sequence does the same from C++14 on; rebuilt here so the
+     * header works from C++11 like the rest of the library.
+     */
+    template<std::size_t... Is>
+    struct index_pack {};
+
+    // Recursive definition: prepend N-1 until reaching zero
+    template<std::size_t N, std::size_t... Is>
+    struct make_index_pack : make_index_pack<N-1, N-1, Is...> {};
+    // Recursion end
+    template<std::size_t... Is>
+    struct make_index_pack<0, Is...> {
+        using type = index_pack<Is...>;
+    };
+    /**********************************************************/
+
+    template<class Function, std::size_t... Is>
+    void template_for_impl(Function& fn, index_pack<Is...>) {
+        int expand[] = {0, (fn(std::integral_constant<std::size_t, Is>()), 0)...};
+        (void)expand;
+    }
+
+    /* Invoke fn once per index in 0..N-1, fully expanded at compile time.
+     * The index parameter is a std::integral_constant<std::size_t, I>, so it
+     * converts to std::size_t in arithmetic and still works as a template
+     * argument.
+     */
+    template<std::size_t N, class Function>
+    void template_for(Function&& fn) {
+        template_for_impl(fn, typename make_index_pack<N>::type());
+    }
+
+    /** Constexpr-friendly fixed range, the compile-time analogue of
+     * range(N) */
+    template<std::size_t N>
+    struct static_range {
+        /// Trip count, usable in constant expressions
+        static constexpr std::size_t size() {
+            return N;
+        }
+
+        /// Unrolled loop over the indices, same expansion as template_for
+        template<class Function>
+        static void for_each(Function&& fn) {
+            template_for<N>(std::forward<Function>(fn));
+        }
+    };
+
+}
+#endif
@@ -0,0 +1,166 @@
+#ifndef _UTIL_STRIDED_HPP_
+#define _UTIL_STRIDED_HPP_
+
+/* A strided view over raw memory: every stride-th element of a buffer,
+ * presented as a container. The main use is walking one field of
+ * interleaved (array-of-structs) data in place, in particular as a zip
+ * operand:
+ *
+ * usage:
+ *     float xyz[3 * n];                               // x0 y0 z0 x1 y1 z1 ...
+ *     for(float& y : strided(xyz + 1, n, 3))
+ *         y *= 2;
+ *     for(auto&& v : zip(strided(xyz + 0, n, 3), weights))
+ *         ...
+ *
+ * The iterator is a base pointer plus an element index, dereferencing
+ * as data[i * stride] - like zip_fast_iterator - so no pointer past the
+ * last field element is ever formed, whatever the field offset. It
+ * models random access, so zip's O(1) advance and the parallel engine's
+ * splitting both apply.
+ */
+
+#include <cstddef>
+#include <iterator>
+
+namespace util {
+
+    /** A view of count elements spaced stride apart in memory
+     *
+     * Non-owning: the caller keeps the buffer alive. The stride is
+     * measured in elements of T, not bytes, and must be at least 1.
+     */
+    template<class T>
+    class Strided_Range {
+        T* _data;
+        std::size_t _count;
+        std::ptrdiff_t _stride;
+    public:
+
+        class Iterator {
+            T* _data;
+            std::ptrdiff_t _stride;
+            std::ptrdiff_t _i;
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = T*;
+            using reference = T&;
+
+            Iterator() noexcept : _data(nullptr), _stride(1), _i(0) {}
+            Iterator(T* data, std::ptrdiff_t stride, std::ptrdiff_t i) noexcept
+                : _data(data), _stride(stride), _i(i) {}
+
+            reference operator*() const noexcept {
+                return _data[_i * _stride];
+            }
+            pointer operator->() const noexcept {
+                return _data + _i * _stride;
+            }
+            reference operator[](difference_type n) const noexcept {
+                return _data[(_i + n) * _stride];
+            }
+
+            Iterator& operator++() noexcept {
+                ++_i;
+                return *this;
+            }
+            Iterator operator++(int) noexcept {
+                Iterator old = *this;
+                ++_i;
+                return old;
+            }
+            Iterator& operator--() noexcept {
+                --_i;
+                return *this;
+            }
+            Iterator operator--(int) noexcept {
+                Iterator old = *this;
+                --_i;
+                return old;
+            }
+            Iterator& operator+=(difference_type n) noexcept {
+                _i += n;
+                return *this;
+            }
+            Iterator& operator-=(difference_type n) noexcept {
+                _i -= n;
+                return *this;
+            }
+            friend Iterator operator+(Iterator it, difference_type n) noexcept {
+                it += n;
+                return it;
+            }
+            friend Iterator operator+(difference_type n, Iterator it) noexcept {
+                it += n;
+                return it;
+            }
+            friend Iterator operator-(Iterator it, difference_type n) noexcept {
+                it -= n;
+                return it;
+            }
+            friend difference_type operator-(const Iterator& lhs,
+                                             const Iterator& rhs) noexcept {
+                return lhs._i - rhs._i;
+            }
+
+            friend bool operator==(const Iterator& lhs, const Iterator& rhs) noexcept {
+                return lhs._i == rhs._i;
+            }
+            friend bool operator!=(const Iterator& lhs, const Iterator& rhs) noexcept {
+                return lhs._i != rhs._i;
+            }
+            friend bool operator<(const Iterator& lhs, const Iterator& rhs) noexcept {
+                return lhs._i < rhs._i;
+            }
+            friend bool operator>(const Iterator& lhs, const Iterator& rhs) noexcept {
+                return rhs < lhs;
+            }
+            friend bool operator<=(const Iterator& lhs, const Iterator& rhs) noexcept {
+                return ! (rhs < lhs);
+            }
+            friend bool operator>=(const Iterator& lhs, const Iterator& rhs) noexcept {
+                return ! (lhs < rhs);
+            }
+        };
+
+        using iterator = Iterator;
+        using const_iterator = Iterator;
+        using value_type = T;
+        using reference = T&;
+        using const_reference = T&;
+
+        Strided_Range(T* data, std::size_t count, std::size_t stride) noexcept
+            : _data(data), _count(count),
+              _stride(static_cast<std::ptrdiff_t>(stride > 0 ? stride : 1)) {}
+
+        Iterator begin() const noexcept {
+            return Iterator(_data, _stride, 0);
+        }
+        Iterator end() const noexcept {
+            return Iterator(_data, _stride,
+                            static_cast<std::ptrdiff_t>(_count));
+        }
+
+        std::size_t size() const noexcept {
+            return _count;
+        }
+        bool empty() const noexcept {
+            return _count == 0;
+        }
+        reference operator[](std::size_t n) const noexcept {
+            return _data[static_cast<std::ptrdiff_t>(n) * _stride];
+        }
+    };
+
+    /* The strided wrapper function. data points at the first element of
+     * the field, count is the number of elements, stride their spacing
+     * in units of T. */
+    template<class T>
+    Strided_Range<T> strided(T* data, std::size_t count, std::size_t stride) noexcept {
+        return Strided_Range<T>(data, count, stride);
+    }
+
+}
+#endif
@@ -0,0 +1,71 @@
+/* Compile-time enforcement of the zero-cost contract.
+ *
+ * The iterators must stay trivially copyable (so they live in registers and
+ * memcpy-like moves stay valid) and the Range iterator operations noexcept.
+ * Any regression here fails the build, not a benchmark run.
+ */
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "range.hpp"
+#include "zip.hpp"
+
+namespace {
+
+    using size_range_it = util::Range<std::size_t>::Iterator;
+    using int_range_it = util::Range<int>::Iterator;
+
+    // Range::Iterator: trivially copyable, nothrow everything
+    static_assert(std::is_trivially_copyable<size_range_it>::value,
+                  "Range<size_t>::Iterator must be trivially copyable");
+    static_assert(std::is_trivially_copyable<int_range_it>::value,
+                  "Range<int>::Iterator must be trivially copyable");
+    static_assert(std::is_nothrow_default_constructible<size_range_it>::value,
+                  "Range iterator construction must not throw");
+    static_assert(std::is_nothrow_copy_constructible<size_range_it>::value,
+                  "Range iterator copies must not throw");
+
+    size_range_it probe;
+    static_assert(noexcept(*probe), "dereference must be noexcept");
+    static_assert(noexcept(++probe), "increment must be noexcept");
+    static_assert(noexcept(probe += 4), "advance must be noexcept");
+    static_assert(noexcept(probe[2]), "subscript must be noexcept");
+    static_assert(noexcept(probe - probe), "difference must be noexcept");
+    static_assert(noexcept(probe == probe), "comparison must be noexcept");
+
+    // Dereference yields a value, never a reference into iterator state
+    static_assert(std::is_same<decltype(*probe), std::size_t>::value,
+                  "Range iterator dereference must return by value");
+
+    // The whole Range is trivially copyable too: three ints and a size
+    static_assert(std::is_trivially_copyable<util::Range<std::size_t>>::value,
+                  "Range must be trivially copyable");
+
+    // zip over vectors: arities 2 and 3 use the flat specializations with
+    // named iterator members, so the whole iterator is trivially copyable.
+    using vec = std::vector<double>;
+    using zip_it = util::zip_iterator<vec&, vec&>;
+    static_assert(std::is_trivially_copyable<zip_it>::value,
+                  "binary zip_iterator must be trivially copyable");
+    using zip3_it = util::zip_iterator<vec&, vec&, vec&>;
+    static_assert(std::is_trivially_copyable<zip3_it>::value,
+                  "ternary zip_iterator must be trivially copyable");
+
+    using zip_fast_it = util::zip_fast_iterator<vec&, vec&>;
+    static_assert(std::is_trivially_copy_constructible<zip_fast_it>::value,
+                  "zip_fast_iterator copies must be trivial");
+    static_assert(std::is_trivially_destructible<zip_fast_it>::value,
+                  "zip_fast_iterator destruction must be trivial");
+
+#if __cplusplus >= 202002L
+    static_assert(std::random_access_iterator<size_range_it>,
+                  "Range iterator must model std::random_access_iterator");
+#endif
+
+}
+
+int main() {
+    return 0;
+}
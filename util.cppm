@@ -0,0 +1,119 @@
+/* C++20 module interface wrapping the library.
+ *
+ * Downstream code can trade the per-translation-unit cost of parsing and
+ * instantiating the headers for a single precompiled module:
+ *
+ *     import util;
+ *     for(auto i : util::range(n)) ...
+ *
+ * The headers stay the primary shipping form; this file re-exports their
+ * public surface unchanged (the UTIL_PROFILED macro cannot cross a module
+ * boundary - include profile.hpp directly where it is wanted).
+ *
+ * This uses the standard wrapping pattern: headers in the global module
+ * fragment, exported using-declarations in the purview. It needs a
+ * toolchain with mature module support (clang 16+, MSVC 19.30+,
+ * gcc 14+); gcc 12's -fmodules-ts compiles the interface but does not
+ * yet re-export the using-declared names to importers.
+ */
+
+module;
+
+#include "enumerate.hpp"
+#include "gather.hpp"
+#include "generator.hpp"
+#include "linspace.hpp"
+#include "mmap_range.hpp"
+#include "parallel_for.hpp"
+#include "product.hpp"
+#include "profile.hpp"
+#include "range.hpp"
+#include "range2d.hpp"
+#include "static_range.hpp"
+#include "strided.hpp"
+#include "views.hpp"
+#include "windowed.hpp"
+#include "zip.hpp"
+
+export module util;
+
+export namespace util {
+
+    // range.hpp
+    using ::util::split;
+    using ::util::Range;
+    using ::util::Lane_Range;
+    using ::util::Chunk_Range;
+    using ::util::range;
+    using ::util::iter_range;
+
+    // range2d.hpp
+    using ::util::Range2d;
+    using ::util::Tiled_Range2d;
+    using ::util::range2d;
+
+    // static_range.hpp
+    using ::util::static_range;
+    using ::util::template_for;
+
+    // linspace.hpp
+    using ::util::Linspace_Range;
+    using ::util::linspace;
+
+    // strided.hpp
+    using ::util::Strided_Range;
+    using ::util::strided;
+
+    // zip.hpp
+    using ::util::zip_iterator;
+    using ::util::zip_impl;
+    using ::util::zip;
+    using ::util::zip_fast;
+    using ::util::zip_sized;
+    using ::util::zip_prefetch;
+    using ::util::for_each_zipped;
+    using ::util::prefetch_read;
+
+    // enumerate.hpp
+    using ::util::enumerate;
+
+    // views.hpp
+    using ::util::transform;
+    using ::util::filter;
+    using ::util::filter_indices;
+
+    // windowed.hpp
+    using ::util::Window;
+    using ::util::windowed;
+
+    // product.hpp
+    using ::util::product;
+    using ::util::product_tiled;
+
+    // gather.hpp
+    using ::util::gather;
+    using ::util::scatter;
+    using ::util::prefetch_write;
+
+    // parallel_for.hpp
+    using ::util::Thread_Pool;
+    using ::util::schedule;
+    using ::util::parallel_for;
+    using ::util::parallel_reduce;
+
+    // mmap_range.hpp
+    using ::util::mmap_advice;
+    using ::util::Mmap_Range;
+    using ::util::mmap_range;
+
+    // generator.hpp
+    using ::util::generator;
+
+    // profile.hpp
+    using ::util::Loop_Record;
+    using ::util::Profile_Registry;
+    using ::util::profiled;
+    using ::util::profile_flush;
+    using ::util::profile_snapshot;
+
+}
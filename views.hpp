@@ -0,0 +1,175 @@
+#ifndef _UTIL_VIEWS_HPP_
+#define _UTIL_VIEWS_HPP_
+
+/* Lazy transform and filter adaptors over the library's iterables.
+ *
+ * Both wrap any container (or range/zip/enumerate view) and apply their
+ * function element by element during iteration: stages fuse into a single
+ * pass with no intermediate vector materialized between them.
+ *
+ * usage:
+ *     for(auto x : transform(range(n), [](std::size_t i) { return i * i; }))
+ *         ...
+ *     for(auto t : filter(zip(a, b), [](std::tuple<double&, double&> t) {
+ *             return std::get<0>(t) > 0; }))
+ *         ...
+ *     // branchless consumption: positions first, gather later
+ *     std::vector<std::size_t> hits = filter_indices(scores, is_hit);
+ */
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "zip.hpp"
+
+namespace util {
+
+    /** Lazily transformed view of an iterable
+     *
+     * \tparam Iterable The wrapped iterable, a reference for lvalue
+     *         arguments.
+     * \tparam Function Applied to each element on dereference.
+     */
+    template<class Iterable, class Function>
+    class transform_impl {
+    public:
+        using inner_iterator = typename iterator_extractor<Iterable>::type;
+        /// What dereferencing produces: the function's result, untouched
+        using reference = decltype(std::declval<const Function&>()(
+            *std::declval<inner_iterator&>()));
+        using const_reference = reference;
+
+        class iterator {
+            inner_iterator _it;
+            const Function* _fn;
+        public:
+            iterator(inner_iterator it, const Function* fn) : _it(it), _fn(fn) {}
+            iterator& operator++() {
+                ++_it;
+                return *this;
+            }
+            reference operator*() const {
+                return (*_fn)(*_it);
+            }
+            bool operator==(const iterator& o) const {
+                return _it == o._it;
+            }
+            bool operator!=(const iterator& o) const {
+                return ! (*this == o);
+            }
+        };
+
+        using const_iterator = iterator;
+
+        transform_impl(Iterable&& iterable, Function fn)
+            : _iterable(std::forward<Iterable>(iterable)), _fn(std::move(fn)) {}
+
+        iterator begin() {
+            return iterator(_iterable.begin(), &_fn);
+        }
+
+        iterator end() {
+            return iterator(_iterable.end(), &_fn);
+        }
+
+    private:
+        Iterable _iterable;
+        Function _fn;
+    };
+
+    /* The transform wrapper function: one fused pass, nothing materialized */
+    template<class Iterable, class Function>
+    auto transform(Iterable&& iterable, Function fn)
+        -> transform_impl<Iterable, Function> {
+        return transform_impl<Iterable, Function>(
+            std::forward<Iterable>(iterable), std::move(fn));
+    }
+
+
+    /** Lazily filtered view of an iterable
+     *
+     * The iterator skips over elements rejected by the predicate as it
+     * advances; the predicate runs exactly once per element.
+     */
+    template<class Iterable, class Predicate>
+    class filter_impl {
+    public:
+        using inner_iterator = typename iterator_extractor<Iterable>::type;
+        /// Dereference passes the element through by reference
+        using reference = decltype(*std::declval<inner_iterator&>());
+        using const_reference = reference;
+
+        class iterator {
+            inner_iterator _it;
+            inner_iterator _last;
+            const Predicate* _pred;
+
+            void skip_rejected() {
+                while (_it != _last && !(*_pred)(*_it))
+                    ++_it;
+            }
+        public:
+            iterator(inner_iterator it, inner_iterator last, const Predicate* pred)
+                : _it(it), _last(last), _pred(pred) {
+                skip_rejected();
+            }
+            iterator& operator++() {
+                ++_it;
+                skip_rejected();
+                return *this;
+            }
+            reference operator*() const {
+                return *_it;
+            }
+            bool operator==(const iterator& o) const {
+                return _it == o._it;
+            }
+            bool operator!=(const iterator& o) const {
+                return ! (*this == o);
+            }
+        };
+
+        using const_iterator = iterator;
+
+        filter_impl(Iterable&& iterable, Predicate pred)
+            : _iterable(std::forward<Iterable>(iterable)), _pred(std::move(pred)) {}
+
+        iterator begin() {
+            return iterator(_iterable.begin(), _iterable.end(), &_pred);
+        }
+
+        iterator end() {
+            return iterator(_iterable.end(), _iterable.end(), &_pred);
+        }
+
+    private:
+        Iterable _iterable;
+        Predicate _pred;
+    };
+
+    /* The filter wrapper function */
+    template<class Iterable, class Predicate>
+    auto filter(Iterable&& iterable, Predicate pred)
+        -> filter_impl<Iterable, Predicate> {
+        return filter_impl<Iterable, Predicate>(
+            std::forward<Iterable>(iterable), std::move(pred));
+    }
+
+    /* Index-precomputation mode of filter: collect the positions of the
+     * accepted elements in one branchy pass, so consumers can run
+     * branch-free gather loops over the positions afterwards.
+     */
+    template<class Iterable, class Predicate>
+    std::vector<std::size_t> filter_indices(Iterable&& iterable, Predicate pred) {
+        std::vector<std::size_t> positions;
+        std::size_t i = 0;
+        for (auto it = iterable.begin(); it != iterable.end(); ++it, ++i) {
+            if (pred(*it))
+                positions.push_back(i);
+        }
+        return positions;
+    }
+
+}
+#endif
@@ -0,0 +1,143 @@
+#ifndef _UTIL_WINDOWED_HPP_
+#define _UTIL_WINDOWED_HPP_
+
+/* A sliding-window view for stencil kernels: every step yields a view of W
+ * consecutive elements, advancing by one element per step. Moving averages
+ * and 1D convolutions write their body against the window instead of
+ * juggling boundary indices around range(k, n - k).
+ *
+ * usage:
+ *     for(auto w : windowed(samples, 5)) {     // n - 4 windows
+ *         double sum = 0;
+ *         for(double x : w) sum += x;
+ *         out.push_back(sum / 5);
+ *     }
+ *     for(auto w : windowed(range(n), 3))      // windows of indices
+ *         ...
+ *
+ * A window is base-iterator plus offsets - nothing is copied, and for
+ * contiguous containers the accesses compile to base-pointer + offset
+ * loads that stay in registers.
+ */
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+
+#include "zip.hpp"
+
+namespace util {
+
+    /** One window of W consecutive elements
+     *
+     * A non-owning view: holds the iterator to the first element and the
+     * width. operator[] is base + offset; with random access iterators it
+     * is O(1).
+     */
+    template<class Iterator>
+    class Window {
+        Iterator _first;
+        std::size_t _width;
+    public:
+        using iterator = Iterator;
+        using reference = decltype(*std::declval<Iterator&>());
+
+        Window(Iterator first, std::size_t width) : _first(first), _width(width) {}
+
+        Iterator begin() const {
+            return _first;
+        }
+
+        Iterator end() const {
+            return std::next(_first, static_cast<std::ptrdiff_t>(_width));
+        }
+
+        std::size_t size() const {
+            return _width;
+        }
+
+        /// Element at offset n from the window base
+        reference operator[](std::size_t n) const {
+            return *std::next(_first, static_cast<std::ptrdiff_t>(n));
+        }
+    };
+
+
+    /** Dummy container yielding sliding windows
+     *
+     * \tparam Container The wrapped iterable, a reference for lvalue
+     *         arguments. A container of n elements produces n - W + 1
+     *         windows (none if n < W).
+     */
+    template<class Container>
+    class windowed_impl {
+    public:
+        using inner_iterator = typename iterator_extractor<Container>::type;
+        /// The window view each step yields
+        using value_type = Window<inner_iterator>;
+
+        class iterator {
+            inner_iterator _it;
+            std::size_t _width;
+        public:
+            iterator(inner_iterator it, std::size_t width)
+                : _it(it), _width(width) {}
+            iterator& operator++() {
+                ++_it;
+                return *this;
+            }
+            value_type operator*() const {
+                return value_type(_it, _width);
+            }
+            bool operator==(const iterator& o) const {
+                return _it == o._it;
+            }
+            bool operator!=(const iterator& o) const {
+                return ! (*this == o);
+            }
+        };
+
+        using const_iterator = iterator;
+
+        windowed_impl(Container&& container, std::size_t width)
+            : _container(std::forward<Container>(container)),
+              _width(width > 0 ? width : 1) {}
+
+        iterator begin() {
+            return iterator(_container.begin(), _width);
+        }
+
+        iterator end() {
+            const std::ptrdiff_t count =
+                std::distance(_container.begin(), _container.end());
+            const std::ptrdiff_t windows =
+                count >= static_cast<std::ptrdiff_t>(_width)
+                ? count - static_cast<std::ptrdiff_t>(_width) + 1
+                : 0;
+            return iterator(std::next(_container.begin(), windows), _width);
+        }
+
+        /// Number of windows produced
+        std::size_t size() {
+            const std::ptrdiff_t count =
+                std::distance(_container.begin(), _container.end());
+            return count >= static_cast<std::ptrdiff_t>(_width)
+                ? static_cast<std::size_t>(count) - _width + 1
+                : 0;
+        }
+
+    private:
+        Container _container;
+        std::size_t _width;
+    };
+
+    /* The windowed wrapper function. Works on containers and on ranges
+     * alike: windowed(range(n), W) slides over the generated indices. */
+    template<class Container>
+    auto windowed(Container&& container, std::size_t width)
+        -> windowed_impl<Container> {
+        return windowed_impl<Container>(std::forward<Container>(container), width);
+    }
+
+}
+#endif
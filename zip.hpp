@@ -4,19 +4,28 @@
 /* A zip implementation  for use in ranged for loops introduced in
  * C++11.
  *
- * usage:
+ * The loop variable is a std::tuple of references into the containers, so
+ * from C++17 on structured bindings are the natural, zero-copy way to
+ * consume it:
+ *
  *     std::array<int, 10> int_array;         // Assume the containers have been
  *     std::vector<std::string> string_array; // initialized and filled
- *     for(auto it : zip(int_array, string_array)) {
- *         int x;
- *         std::string s;
- *         std::tie(x, s) = *it;
+ *     for(auto&& [x, s] : zip(int_array, string_array)) {
+ *         // x and s are true references, writes go to the containers
+ *     }
+ *
+ * In C++11/14, unpack through std::tie (beware: naming the locals by value
+ * copies the elements) or std::get:
  *
- *         int& x_bis = std::get<O>(*it);
+ *     for(auto t : zip(int_array, string_array)) {
+ *         int& x = std::get<0>(t);
+ *         std::string& s = std::get<1>(t);
  *         // ... anything with x and s
  *     }
  */
 
+#include <cstdint>
+#include <iterator>
 #include <tuple>
 #include <type_traits>
 
@@ -122,15 +131,16 @@ namespace util {
             return *this;
         }
 
+        /* Advance every member through std::advance, whose internal tag
+         * dispatch makes this O(1) for random access members and stepping
+         * only for the others. */
         zip_iterator& operator+=(const std::size_t& n) {
-            operator+=<0, Args...>(n);
+            advance<0, Args...>(static_cast<std::ptrdiff_t>(n));
             return *this;
         }
 
         zip_iterator& operator-=(const std::size_t& n) {
-            for(std::size_t i = 0; i < n; ++i) {
-                --(*this);
-            }
+            advance<0, Args...>(-static_cast<std::ptrdiff_t>(n));
             return *this;
         }
 
@@ -138,12 +148,19 @@ namespace util {
             return (it -= n);
         }
 
+        /* Distance between two zip iterators. The members advance in
+         * lockstep, so the first one carries the answer; O(1) when it is
+         * random access. */
+        friend std::ptrdiff_t operator-(const zip_iterator& lhs, const zip_iterator& rhs) {
+            return std::distance(std::get<0>(rhs), std::get<0>(lhs));
+        }
+
         friend zip_iterator operator+(zip_iterator it, const std::size_t& n) {
             return (it += n);
         }
 
         /// Dereference operator, gets the pointed objects
-        reference_tuple operator*() {
+        reference_tuple operator*() const {
             return this->operator*<0, Args...>();
         }
 
@@ -156,16 +173,33 @@ namespace util {
             return ! this->operator==<0,Args...>(other);
         }
 
+        /* Uniform access to the Idx-th member iterator; the flat
+         * specializations below provide the same accessor, so adaptors
+         * need not know how the members are stored. */
+        template<std::size_t Idx>
+        typename std::tuple_element<
+            Idx, typename iterator_type_tuple<Args...>::type>::type&
+        member() {
+            return std::get<Idx>(*this);
+        }
+
+        template<std::size_t Idx>
+        const typename std::tuple_element<
+            Idx, typename iterator_type_tuple<Args...>::type>::type&
+        member() const {
+            return std::get<Idx>(*this);
+        }
+
     private:
 
         template<int Idx, class A, class... B>
-        void operator+=(const std::size_t& n) {
-            operator+=<Idx+1,B...>(n);
-            std::get<Idx>(*this) = std::get<Idx>(*this) + n;
+        void advance(const std::ptrdiff_t n) {
+            advance<Idx+1,B...>(n);
+            std::advance(std::get<Idx>(*this), n);
         }
 
         template<int>
-        void operator+=(const std::size_t&) {}
+        void advance(const std::ptrdiff_t) {}
 
         template<int Idx, class A, class... B>
         void operator--() {
@@ -177,7 +211,7 @@ namespace util {
         void operator--() {}
 
         template<int, class A, class... B>
-        typename reference_type_tuple<A, B...>::type operator*() {
+        typename reference_type_tuple<A, B...>::type operator*() const {
             std::tuple<typename reference_extractor<A>::type> temp(*(std::get<len - sizeof...(B)-1>(*this)));
             return std::tuple_cat(temp, this->operator*<1, B...>());
         }
@@ -225,10 +259,17 @@ namespace util {
     struct zip_impl {
         /// The zip iterator type
         using iterator = zip_iterator<Args...>;
+        /// Same iterator either way; it already respects const containers
+        using const_iterator = zip_iterator<Args...>;
+        /// Tuple of element references, so zips compose with other adaptors
+        using reference = typename reference_type_tuple<Args...>::type;
+        using const_reference = reference;
         /// The number of containers wrapped inside
         constexpr static std::size_t len = sizeof...(Args);
-        /// An array of references to the actual containers
-        std::tuple<Args&&...> containers;
+        /* The wrapped containers: a reference for each lvalue argument, an
+         * owned (moved-in) copy for each rvalue argument, so temporaries
+         * passed to zip() live as long as the loop that consumes them. */
+        std::tuple<Args...> containers;
 
         /*zip_impl() {}*/
 
@@ -266,6 +307,401 @@ namespace util {
         void end(iterator&) {}
     };
 
+
+    /* Flat specializations for the common arities.
+     *
+     * The generic zip_iterator inherits from a std::tuple of iterators and
+     * walks it with recursive member templates; some compilers leave parts
+     * of that chain uninlined at -O2. Binary and ternary zips are the
+     * overwhelmingly common cases, so they get straight-line
+     * specializations: named iterator members, no tuple base, no recursion
+     * anywhere in increment, compare or dereference.
+     */
+    template<class A, class B>
+    class zip_iterator<A, B> {
+        using iterator_a = typename iterator_extractor<A>::type;
+        using iterator_b = typename iterator_extractor<B>::type;
+
+        iterator_a _a;
+        iterator_b _b;
+
+    public:
+        using reference_tuple = typename reference_type_tuple<A, B>::type;
+        constexpr static std::size_t len = 2;
+
+        zip_iterator() : _a(), _b() {}
+        zip_iterator(iterator_a a, iterator_b b) : _a(a), _b(b) {}
+
+        zip_iterator& operator++() {
+            ++_a;
+            ++_b;
+            return *this;
+        }
+
+        zip_iterator& operator--() {
+            --_a;
+            --_b;
+            return *this;
+        }
+
+        zip_iterator& operator+=(const std::size_t& n) {
+            const std::ptrdiff_t d = static_cast<std::ptrdiff_t>(n);
+            std::advance(_a, d);
+            std::advance(_b, d);
+            return *this;
+        }
+
+        zip_iterator& operator-=(const std::size_t& n) {
+            const std::ptrdiff_t d = -static_cast<std::ptrdiff_t>(n);
+            std::advance(_a, d);
+            std::advance(_b, d);
+            return *this;
+        }
+
+        friend zip_iterator operator+(zip_iterator it, const std::size_t& n) {
+            return (it += n);
+        }
+
+        friend zip_iterator operator-(zip_iterator it, const std::size_t& n) {
+            return (it -= n);
+        }
+
+        friend std::ptrdiff_t operator-(const zip_iterator& lhs,
+                                        const zip_iterator& rhs) {
+            return std::distance(rhs._a, lhs._a);
+        }
+
+        reference_tuple operator*() const {
+            return reference_tuple(*_a, *_b);
+        }
+
+        // same convention as the generic case: the zip ends when any
+        // member reaches its end
+        bool operator==(const zip_iterator& other) const {
+            return _a == other._a || _b == other._b;
+        }
+
+        bool operator!=(const zip_iterator& other) const {
+            return ! (*this == other);
+        }
+
+        template<std::size_t Idx>
+        typename std::tuple_element<Idx, std::tuple<iterator_a, iterator_b>>::type&
+        member() {
+            return member_impl(std::integral_constant<std::size_t, Idx>());
+        }
+
+        template<std::size_t Idx>
+        const typename std::tuple_element<Idx, std::tuple<iterator_a, iterator_b>>::type&
+        member() const {
+            return member_impl(std::integral_constant<std::size_t, Idx>());
+        }
+
+    private:
+        iterator_a& member_impl(std::integral_constant<std::size_t, 0>) { return _a; }
+        iterator_b& member_impl(std::integral_constant<std::size_t, 1>) { return _b; }
+        const iterator_a& member_impl(std::integral_constant<std::size_t, 0>) const { return _a; }
+        const iterator_b& member_impl(std::integral_constant<std::size_t, 1>) const { return _b; }
+    };
+
+
+    template<class A, class B, class C>
+    class zip_iterator<A, B, C> {
+        using iterator_a = typename iterator_extractor<A>::type;
+        using iterator_b = typename iterator_extractor<B>::type;
+        using iterator_c = typename iterator_extractor<C>::type;
+
+        iterator_a _a;
+        iterator_b _b;
+        iterator_c _c;
+
+    public:
+        using reference_tuple = typename reference_type_tuple<A, B, C>::type;
+        constexpr static std::size_t len = 3;
+
+        zip_iterator() : _a(), _b(), _c() {}
+        zip_iterator(iterator_a a, iterator_b b, iterator_c c)
+            : _a(a), _b(b), _c(c) {}
+
+        zip_iterator& operator++() {
+            ++_a;
+            ++_b;
+            ++_c;
+            return *this;
+        }
+
+        zip_iterator& operator--() {
+            --_a;
+            --_b;
+            --_c;
+            return *this;
+        }
+
+        zip_iterator& operator+=(const std::size_t& n) {
+            const std::ptrdiff_t d = static_cast<std::ptrdiff_t>(n);
+            std::advance(_a, d);
+            std::advance(_b, d);
+            std::advance(_c, d);
+            return *this;
+        }
+
+        zip_iterator& operator-=(const std::size_t& n) {
+            const std::ptrdiff_t d = -static_cast<std::ptrdiff_t>(n);
+            std::advance(_a, d);
+            std::advance(_b, d);
+            std::advance(_c, d);
+            return *this;
+        }
+
+        friend zip_iterator operator+(zip_iterator it, const std::size_t& n) {
+            return (it += n);
+        }
+
+        friend zip_iterator operator-(zip_iterator it, const std::size_t& n) {
+            return (it -= n);
+        }
+
+        friend std::ptrdiff_t operator-(const zip_iterator& lhs,
+                                        const zip_iterator& rhs) {
+            return std::distance(rhs._a, lhs._a);
+        }
+
+        reference_tuple operator*() const {
+            return reference_tuple(*_a, *_b, *_c);
+        }
+
+        bool operator==(const zip_iterator& other) const {
+            return _a == other._a || _b == other._b || _c == other._c;
+        }
+
+        bool operator!=(const zip_iterator& other) const {
+            return ! (*this == other);
+        }
+
+        template<std::size_t Idx>
+        typename std::tuple_element<
+            Idx, std::tuple<iterator_a, iterator_b, iterator_c>>::type&
+        member() {
+            return member_impl(std::integral_constant<std::size_t, Idx>());
+        }
+
+        template<std::size_t Idx>
+        const typename std::tuple_element<
+            Idx, std::tuple<iterator_a, iterator_b, iterator_c>>::type&
+        member() const {
+            return member_impl(std::integral_constant<std::size_t, Idx>());
+        }
+
+    private:
+        iterator_a& member_impl(std::integral_constant<std::size_t, 0>) { return _a; }
+        iterator_b& member_impl(std::integral_constant<std::size_t, 1>) { return _b; }
+        iterator_c& member_impl(std::integral_constant<std::size_t, 2>) { return _c; }
+        const iterator_a& member_impl(std::integral_constant<std::size_t, 0>) const { return _a; }
+        const iterator_b& member_impl(std::integral_constant<std::size_t, 1>) const { return _b; }
+        const iterator_c& member_impl(std::integral_constant<std::size_t, 2>) const { return _c; }
+    };
+
+
+    /* The matching zip_impl specializations build the flat iterators
+     * directly; the containers member keeps the generic layout so the
+     * sized/prefetch adaptors stay oblivious. */
+    template<class A, class B>
+    struct zip_impl<A, B> {
+        using iterator = zip_iterator<A, B>;
+        using const_iterator = zip_iterator<A, B>;
+        using reference = typename reference_type_tuple<A, B>::type;
+        using const_reference = reference;
+        constexpr static std::size_t len = 2;
+
+        std::tuple<A, B> containers;
+
+        zip_impl(A&& a, B&& b)
+            : containers(std::forward<A>(a), std::forward<B>(b)) {}
+
+        iterator begin() {
+            return iterator(std::get<0>(containers).begin(),
+                            std::get<1>(containers).begin());
+        }
+
+        iterator end() {
+            return iterator(std::get<0>(containers).end(),
+                            std::get<1>(containers).end());
+        }
+    };
+
+    template<class A, class B, class C>
+    struct zip_impl<A, B, C> {
+        using iterator = zip_iterator<A, B, C>;
+        using const_iterator = zip_iterator<A, B, C>;
+        using reference = typename reference_type_tuple<A, B, C>::type;
+        using const_reference = reference;
+        constexpr static std::size_t len = 3;
+
+        std::tuple<A, B, C> containers;
+
+        zip_impl(A&& a, B&& b, C&& c)
+            : containers(std::forward<A>(a), std::forward<B>(b),
+                         std::forward<C>(c)) {}
+
+        iterator begin() {
+            return iterator(std::get<0>(containers).begin(),
+                            std::get<1>(containers).begin(),
+                            std::get<2>(containers).begin());
+        }
+
+        iterator end() {
+            return iterator(std::get<0>(containers).end(),
+                            std::get<1>(containers).end(),
+                            std::get<2>(containers).end());
+        }
+    };
+
+    /// Pointer into a container's contiguous storage, as given by data()
+    template<class A>
+    struct data_pointer_extractor {
+        using type = decltype(
+            std::declval<typename std::remove_reference<A>::type&>().data());
+    };
+
+    template<class... A>
+    using data_pointer_tuple = type_extractor_tuple<data_pointer_extractor, A...>;
+
+    /// Reference produced by indexing a container's contiguous storage
+    template<class A>
+    struct data_reference_extractor {
+        using type = decltype(
+            std::declval<typename std::remove_reference<A>::type&>().data()[0]);
+    };
+
+    template<class... A>
+    using data_reference_tuple = type_extractor_tuple<data_reference_extractor, A...>;
+    /**********************************************************/
+
+
+    /** Single-counter iterator over contiguous containers
+     *
+     * Where zip_iterator advances N iterators and compares N pairs per step,
+     * this one advances one index and compares it against a precomputed
+     * bound, dereferencing through raw pointers. The loop the compiler sees
+     * is the same as a hand-written indexed loop, so it vectorizes the same.
+     */
+    template<class... Args>
+    class zip_fast_iterator {
+    public:
+        using pointer_tuple = typename data_pointer_tuple<Args...>::type;
+        using reference_tuple = typename data_reference_tuple<Args...>::type;
+        constexpr static std::size_t len = sizeof...(Args);
+
+        zip_fast_iterator(const pointer_tuple& data, std::size_t idx)
+            : _data(data), _idx(idx) {}
+
+        zip_fast_iterator& operator++() {
+            ++_idx;
+            return *this;
+        }
+
+        reference_tuple operator*() const {
+            return this->deref<0, Args...>();
+        }
+
+        bool operator==(const zip_fast_iterator& other) const {
+            return _idx == other._idx;
+        }
+
+        bool operator!=(const zip_fast_iterator& other) const {
+            return _idx != other._idx;
+        }
+
+    private:
+        pointer_tuple _data;
+        std::size_t _idx;
+
+        template<int, class A, class... B>
+        typename data_reference_tuple<A, B...>::type deref() const {
+            std::tuple<typename data_reference_extractor<A>::type>
+                temp(std::get<len - sizeof...(B)-1>(_data)[_idx]);
+            return std::tuple_cat(temp, this->deref<1, B...>());
+        }
+
+        template<int>
+        std::tuple<> deref() const {
+            return std::tuple<>();
+        }
+    };
+
+
+    /** Dummy container for the fast zip path
+     *
+     * Captures data() pointers and the minimum size once at construction;
+     * iteration is then a single counter against that bound. Only valid for
+     * lvalue containers with contiguous storage (data()/size()), and the
+     * containers must outlive the view since only raw pointers are kept.
+     */
+    template<class... Args>
+    struct zip_fast_impl {
+        using iterator = zip_fast_iterator<Args...>;
+        constexpr static std::size_t len = sizeof...(Args);
+
+        typename data_pointer_tuple<Args...>::type _data;
+        std::size_t _size;
+
+        zip_fast_impl(Args&&... args)
+            : _data(args.data()...), _size(min_size(args...)) {}
+
+        iterator begin() const {
+            return iterator(_data, 0);
+        }
+
+        iterator end() const {
+            return iterator(_data, _size);
+        }
+
+        std::size_t size() const {
+            return _size;
+        }
+
+    private:
+        template<class A>
+        static std::size_t min_size(const A& a) {
+            return a.size();
+        }
+
+        template<class A, class... B>
+        static std::size_t min_size(const A& a, const B&... b) {
+            const std::size_t rest = min_size(b...);
+            return a.size() < rest ? a.size() : rest;
+        }
+    };
+
+    /// True when every pack member deduced as an lvalue reference
+    template<class...>
+    struct all_lvalue_references : std::true_type {};
+
+    template<class A, class... B>
+    struct all_lvalue_references<A, B...>
+        : std::integral_constant<bool,
+              std::is_lvalue_reference<A>::value
+              && all_lvalue_references<B...>::value> {};
+
+    /* The fast zip entry point: same loop shape as zip(), restricted to
+     * contiguous containers.
+     *
+     * usage:
+     *     for(auto t : zip_fast(prices, volumes)) {
+     *         std::get<0>(t) *= std::get<1>(t);
+     *     }
+     */
+    template<typename... T>
+    auto zip_fast(T&&... containers) -> zip_fast_impl<T...> {
+        // only raw pointers are kept: a temporary dies before the loop
+        // starts, so there is no valid rvalue use - zip() owns rvalues
+        static_assert(all_lvalue_references<T...>::value,
+                      "zip_fast() requires lvalue containers; "
+                      "use zip() for temporaries");
+        return zip_fast_impl<T...>(std::forward<T>(containers)...);
+    }
+
+
     /* A zip wrapper function for ranged iteration.
      *
      * This function returns a dummy container that represents all of its arguments.
@@ -273,13 +709,8 @@ namespace util {
      * usage:
      *     std::array<int, 10> int_array;         // Assume the containers have been
      *     std::vector<std::string> string_array; // initialized and filled
-     *     for(auto it : zip(int_array, string_array)) {
-     *         int x;
-     *         std::string s;
-     *         std::tie(x, s) = *it;
-     *
-     *         int& x_bis = std::get<O>(*it);
-     *         // ... anything with x and s
+     *     for(auto&& [x, s] : zip(int_array, string_array)) {
+     *         // x is an int&, s a std::string&, no element copied
      *     }
      */
     template<typename... T>
@@ -287,6 +718,290 @@ namespace util {
         return zip_impl<T...>(std::forward<T>(containers)...);
     }
 
+
+    /** Trip-counted wrapper around zip_iterator
+     *
+     * Advances the member iterators like zip_iterator but decides the end
+     * of the loop with a single counter against a precomputed bound: one
+     * compare and one branch per step regardless of arity, instead of the
+     * recursive pairwise comparison chain.
+     */
+    template<class... Args>
+    class zip_sized_iterator {
+    public:
+        using inner_iterator = zip_iterator<Args...>;
+        using reference_tuple = typename inner_iterator::reference_tuple;
+
+        zip_sized_iterator(inner_iterator it, std::size_t trip)
+            : _it(it), _trip(trip) {}
+
+        zip_sized_iterator& operator++() {
+            ++_it;
+            ++_trip;
+            return *this;
+        }
+
+        reference_tuple operator*() const {
+            return *_it;
+        }
+
+        bool operator==(const zip_sized_iterator& other) const {
+            return _trip == other._trip;
+        }
+
+        bool operator!=(const zip_sized_iterator& other) const {
+            return _trip != other._trip;
+        }
+
+    private:
+        inner_iterator _it;
+        std::size_t _trip;
+    };
+
+
+    /** Dummy container for the trip-counted zip
+     *
+     * Computes min(size(args)...) once at construction; iteration then
+     * needs no tuple of end iterators at all. Requires every argument to
+     * expose size(), but not contiguity - for the contiguous case
+     * zip_fast() drops the member iterators too.
+     */
+    template<class... Args>
+    struct zip_sized_impl {
+        using iterator = zip_sized_iterator<Args...>;
+        constexpr static std::size_t len = sizeof...(Args);
+
+        zip_impl<Args...> _zip;
+        std::size_t _size;
+
+        zip_sized_impl(Args&&... args)
+            : _zip(std::forward<Args>(args)...), _size(min_size<1, Args...>()) {}
+
+        iterator begin() {
+            return iterator(_zip.begin(), 0);
+        }
+
+        iterator end() {
+            // only the trip count matters in comparisons
+            return iterator(_zip.begin(), _size);
+        }
+
+        std::size_t size() const {
+            return _size;
+        }
+
+    private:
+        template<int, class A, class... B>
+        std::size_t min_size() const {
+            const std::size_t s = std::get<len - sizeof...(B)-1>(_zip.containers).size();
+            const std::size_t rest = min_size<1, B...>();
+            return s < rest ? s : rest;
+        }
+
+        template<int>
+        std::size_t min_size() const {
+            return static_cast<std::size_t>(-1);
+        }
+    };
+
+    /* The trip-counted zip entry point: zip semantics, one end test.
+     *
+     * usage:
+     *     for(auto&& [w, x, y, z] : zip_sized(a, b, c, d))
+     *         ...   // one compare per step, not four
+     */
+    template<typename... T>
+    auto zip_sized(T&&... containers) -> zip_sized_impl<T...> {
+        return zip_sized_impl<T...>(std::forward<T>(containers)...);
+    }
+
+
+    /// Portable wrapper around the compiler's prefetch hint
+    template<class T>
+    inline void prefetch_read(const T* address) {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(address, 0, 3);
+#else
+        (void)address;
+#endif
+    }
+
+    /** Prefetching wrapper around zip_iterator
+     *
+     * Each increment additionally issues a read-prefetch hint for the
+     * element Distance steps ahead in every wrapped container, and one
+     * indirection deeper when the element itself is a raw pointer (the
+     * pointer-chasing case the hints are for). Prefetching stops Distance
+     * steps before the end so no past-the-end element is ever formed.
+     */
+    template<std::size_t Distance, class... Args>
+    class zip_prefetch_iterator {
+    public:
+        using inner_iterator = zip_iterator<Args...>;
+        using reference_tuple = typename inner_iterator::reference_tuple;
+        constexpr static std::size_t len = sizeof...(Args);
+
+        zip_prefetch_iterator(inner_iterator it, std::ptrdiff_t ahead)
+            : _it(it), _ahead(ahead) {}
+
+        zip_prefetch_iterator& operator++() {
+            ++_it;
+            if (_ahead > 0) {
+                --_ahead;
+                inner_iterator target = _it + Distance;
+                prefetch_members<0, Args...>(target);
+            }
+            return *this;
+        }
+
+        reference_tuple operator*() const {
+            return *_it;
+        }
+
+        bool operator==(const zip_prefetch_iterator& other) const {
+            return _it == other._it;
+        }
+
+        bool operator!=(const zip_prefetch_iterator& other) const {
+            return _it != other._it;
+        }
+
+    private:
+        inner_iterator _it;
+        std::ptrdiff_t _ahead;  // steps for which prefetching stays in bounds
+
+        template<int Idx, class A, class... B>
+        void prefetch_members(const inner_iterator& target) const {
+            prefetch_members<Idx+1, B...>(target);
+            prefetch_element(*(target.template member<Idx>()));
+        }
+
+        template<int>
+        void prefetch_members(const inner_iterator&) const {}
+
+        template<class T>
+        static void prefetch_element(const T& element) {
+            prefetch_read(&element);
+            prefetch_pointee(element,
+                std::is_pointer<typename std::remove_cv<T>::type>());
+        }
+
+        /// One indirection deep for pointer elements
+        template<class T>
+        static void prefetch_pointee(const T& pointer, std::true_type) {
+            if (pointer != nullptr)
+                prefetch_read(pointer);
+        }
+
+        template<class T>
+        static void prefetch_pointee(const T&, std::false_type) {}
+    };
+
+
+    /** Dummy container for the prefetching zip
+     *
+     * Wraps the ordinary zip_impl and hands out prefetching iterators. The
+     * distance bound is computed once at begin() from the shortest wrapped
+     * container.
+     */
+    template<std::size_t Distance, class... Args>
+    struct zip_prefetch_impl {
+        using iterator = zip_prefetch_iterator<Distance, Args...>;
+        constexpr static std::size_t len = sizeof...(Args);
+
+        zip_impl<Args...> _zip;
+
+        zip_prefetch_impl(Args&&... args)
+            : _zip(std::forward<Args>(args)...) {}
+
+        iterator begin() {
+            // after i increments the target sits at index i + Distance, which
+            // must stay at most size - 1
+            std::ptrdiff_t ahead = min_distance<1, Args...>(_zip.begin(), _zip.end())
+                - static_cast<std::ptrdiff_t>(Distance) - 1;
+            return iterator(_zip.begin(), ahead > 0 ? ahead : 0);
+        }
+
+        iterator end() {
+            return iterator(_zip.end(), 0);
+        }
+
+    private:
+        template<int, class A, class... B>
+        static std::ptrdiff_t min_distance(const zip_iterator<Args...>& first,
+                                           const zip_iterator<Args...>& last) {
+            const std::ptrdiff_t d = std::distance(
+                first.template member<len - sizeof...(B)-1>(),
+                last.template member<len - sizeof...(B)-1>());
+            const std::ptrdiff_t rest = min_distance<1, B...>(first, last);
+            return d < rest ? d : rest;
+        }
+
+        template<int>
+        static std::ptrdiff_t min_distance(const zip_iterator<Args...>&,
+                                           const zip_iterator<Args...>&) {
+            return PTRDIFF_MAX;
+        }
+    };
+
+    /* The prefetching zip entry point.
+     *
+     * usage:
+     *     for(auto&& [offset, node] : zip_prefetch<16>(offsets, nodes)) {
+     *         total += node->weight;   // *node was prefetched 16 steps ago
+     *     }
+     */
+    template<std::size_t Distance, typename... T>
+    auto zip_prefetch(T&&... containers) -> zip_prefetch_impl<Distance, T...> {
+        return zip_prefetch_impl<Distance, T...>(std::forward<T>(containers)...);
+    }
+
+
+    /* Iterator pair walked by for_each_zipped */
+    template<class It>
+    struct zip_cursor {
+        It cur;
+        It last;
+    };
+
+    template<class It>
+    zip_cursor<It> make_zip_cursor(It first, It last) {
+        return zip_cursor<It>{first, last};
+    }
+
+    inline bool zip_cursors_alive() {
+        return true;
+    }
+
+    // Like zip_iterator's comparison: the loop ends when any container does
+    template<class P, class... Rest>
+    bool zip_cursors_alive(const P& p, const Rest&... rest) {
+        return p.cur != p.last && zip_cursors_alive(rest...);
+    }
+
+    template<class Function, class... Cursors>
+    void for_each_zipped_loop(Function& f, Cursors... cursors) {
+        while (zip_cursors_alive(cursors...)) {
+            f((*cursors.cur)...);
+            int advance_all[] = {0, (++cursors.cur, 0)...};
+            (void)advance_all;
+        }
+    }
+
+    /* Apply-style zipped loop: walks the containers once and hands the
+     * elements to f as direct references, with no reference_tuple built and
+     * no std::get/std::tie unpacking in the body.
+     *
+     * usage:
+     *     for_each_zipped([](double p, double v, double& out) {
+     *         out = p * v;
+     *     }, prices, volumes, totals);
+     */
+    template<class Function, class... Args>
+    void for_each_zipped(Function&& f, Args&&... containers) {
+        for_each_zipped_loop(f, make_zip_cursor(containers.begin(), containers.end())...);
+    }
+
 }
 
 